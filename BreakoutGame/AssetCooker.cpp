@@ -0,0 +1,247 @@
+#include "AssetCooker.h"
+#include "AssetPack.h"
+#include "GameSimulation.h"
+#include "ImageResampler.h"
+#include "LevelData.h"
+#include "LevelImage.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+const char* CookedRoot = "Cooked";
+
+const char CookedMagic[4] = { 'B', 'T', 'E', 'X' };
+const uint32_t CookedVersion = 1;
+
+/* Little endian on every supported platform, rows of Pitch bytes follow directly */
+struct CookedTextureHeader
+{
+    char Magic[4];
+    uint32_t Version;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t Pitch;
+    uint32_t Reserved;
+};
+
+std::string GetCookedTexturePath(const std::string& SourcePath, int Width, int Height)
+{
+	std::filesystem::path Path = std::filesystem::path(CookedRoot) / SourcePath;
+
+	if (Width > 0 && Height > 0)
+	{
+		Path.replace_extension("." + std::to_string(Width) + "x" + std::to_string(Height) + ".tex");
+	}
+
+	else
+	{
+		Path.replace_extension(".tex");
+	}
+
+	return Path.generic_string();
+}
+
+std::string GetCookedLevelPath(const std::string& SourcePath)
+{
+	std::filesystem::path Path = std::filesystem::path(CookedRoot) / SourcePath;
+	Path.replace_extension(".lvl");
+	return Path.generic_string();
+}
+
+bool IsCookedUpToDate(const std::string& CookedPath, const std::string& SourcePath)
+{
+	/* A source edited after cooking wins over the stale result */
+	std::error_code Error;
+	auto CookedTime = std::filesystem::last_write_time(CookedPath, Error);
+	if (Error) return false;
+
+	auto SourceTime = std::filesystem::last_write_time(SourcePath, Error);
+	return Error || SourceTime <= CookedTime;
+}
+
+bool WriteCookedTexture(const std::string& Path, const DecodedImage& Image)
+{
+	std::error_code Error;
+	std::filesystem::create_directories(std::filesystem::path(Path).parent_path(), Error);
+
+	std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+	if (!File) return false;
+
+	CookedTextureHeader Header;
+	std::memcpy(Header.Magic, CookedMagic, sizeof(CookedMagic));
+	Header.Version = CookedVersion;
+	Header.Width = Image.Width;
+	Header.Height = Image.Height;
+	Header.Pitch = Image.Width * 4;
+	Header.Reserved = 0;
+
+	File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+	File.write(reinterpret_cast<const char*>(Image.Pixels.data()), Image.Pixels.size());
+	return (bool)File;
+}
+
+static bool IsValidCookedHeader(const CookedTextureHeader& Header, int Width, int Height)
+{
+	return std::memcmp(Header.Magic, CookedMagic, sizeof(CookedMagic)) == 0 && Header.Version == CookedVersion
+		&& Header.Width > 0 && Header.Height > 0 && Header.Width <= 16384 && Header.Height <= 16384 && Header.Pitch == Header.Width * 4
+		&& (Width <= 0 || ((int)Header.Width == Width && (int)Header.Height == Height));
+}
+
+bool LoadCookedTexture(const std::string& SourcePath, DecodedImage& Image, int Width, int Height)
+{
+	std::string Path = GetCookedTexturePath(SourcePath, Width, Height);
+	CookedTextureHeader Header;
+
+	/* Packed blobs are copied straight out of the mapping. A pack is built from one cook, so there is nothing to compare timestamps against. */
+	const unsigned char* Data;
+	size_t Size;
+
+	if (AssetPack::Find(Path.c_str(), Data, Size))
+	{
+		if (Size >= sizeof(Header)) std::memcpy(&Header, Data, sizeof(Header));
+
+		if (Size < sizeof(Header) || !IsValidCookedHeader(Header, Width, Height) || Size - sizeof(Header) < (size_t)Header.Pitch * Header.Height)
+		{
+			std::cerr << "Cooked Texture is corrupt: " << Path << std::endl;
+			return false;
+		}
+
+		Image.Width = Header.Width;
+		Image.Height = Header.Height;
+		Image.Pixels.assign(Data + sizeof(Header), Data + sizeof(Header) + (size_t)Header.Pitch * Header.Height);
+		return true;
+	}
+
+	if (!IsCookedUpToDate(Path, SourcePath)) return false;
+
+	std::ifstream File(Path, std::ios::binary);
+	if (!File.read(reinterpret_cast<char*>(&Header), sizeof(Header))) return false;
+
+	if (!IsValidCookedHeader(Header, Width, Height))
+	{
+		std::cerr << "Cooked Texture is corrupt: " << Path << std::endl;
+		return false;
+	}
+
+	Image.Width = Header.Width;
+	Image.Height = Header.Height;
+	Image.Pixels.resize((size_t)Header.Pitch * Header.Height);
+
+	if (!File.read(reinterpret_cast<char*>(Image.Pixels.data()), Image.Pixels.size()))
+	{
+		std::cerr << "Cooked Texture is truncated: " << Path << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+int RunAssetCooker(int WindowWidth, int WindowHeight)
+{
+	std::set<std::string> Textures;
+	std::set<std::string> Backgrounds;
+	std::error_code Error;
+
+	for (const auto& Entry : std::filesystem::recursive_directory_iterator("Assets/Textures", Error))
+	{
+		if (Entry.is_regular_file() && Entry.path().extension() == ".dds") Textures.insert(Entry.path().generic_string());
+	}
+
+	int Failures = 0;
+	int LevelCount = 0;
+
+	/* Levels are compiled to binary images and may reference textures outside Assets/Textures */
+	for (const auto& Entry : std::filesystem::directory_iterator("Assets/Levels", Error))
+	{
+		if (!Entry.is_regular_file() || Entry.path().extension() != ".xml") continue;
+
+		std::string Source = Entry.path().generic_string();
+		std::ifstream File(Source, std::ios::binary);
+		std::string Text((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+
+		LevelData Level;
+		if (!ParseLevel(Text.data(), Text.size(), Level))
+		{
+			std::cerr << "Cooking failed, can not parse " << Source << std::endl;
+			Failures++;
+			continue;
+		}
+
+		std::vector<unsigned char> Image;
+		CompileLevel(Level, Image);
+
+		std::string Path = GetCookedLevelPath(Source);
+		std::filesystem::create_directories(std::filesystem::path(Path).parent_path(), Error);
+		std::ofstream Compiled(Path, std::ios::binary | std::ios::trunc);
+		Compiled.write(reinterpret_cast<const char*>(Image.data()), Image.size());
+
+		if (!Compiled)
+		{
+			std::cerr << "Cooking failed, can not write " << Path << std::endl;
+			Failures++;
+			continue;
+		}
+
+		std::cout << Source << " -> " << Path << " (" << Image.size() << " bytes)" << std::endl;
+		LevelCount++;
+
+		Textures.insert(Level.BackgroundPath.GetPath());
+		Backgrounds.insert(Level.BackgroundPath.GetPath());
+		for (const BrickType& Type : Level.BrickTypes) Textures.insert(Type.Texture.GetPath());
+	}
+
+	int BackgroundX, BackgroundY, BackgroundWidth = 0, BackgroundHeight = 0;
+	if (WindowWidth > 0 && WindowHeight > 0)
+	{
+		GetBackgroundRect(WindowWidth, WindowHeight, BackgroundX, BackgroundY, BackgroundWidth, BackgroundHeight);
+	}
+
+	size_t Bytes = 0;
+
+	for (const std::string& Source : Textures)
+	{
+		if (Source.empty()) continue;
+
+		DecodedImage Image;
+		if (!LoadDdsFile(Source, Image))
+		{
+			std::cerr << "Cooking failed, can not decode " << Source << std::endl;
+			Failures++;
+			continue;
+		}
+
+		std::string Path = GetCookedTexturePath(Source);
+		if (!WriteCookedTexture(Path, Image))
+		{
+			std::cerr << "Cooking failed, can not write " << Path << std::endl;
+			Failures++;
+			continue;
+		}
+
+		std::cout << Source << " -> " << Path << " (" << Image.Width << "x" << Image.Height << ")" << std::endl;
+		Bytes += Image.Pixels.size();
+
+		if (BackgroundWidth > 0 && BackgroundHeight > 0 && Backgrounds.count(Source) != 0 && (Image.Width != BackgroundWidth || Image.Height != BackgroundHeight))
+		{
+			DecodedImage Scaled;
+			ResampleImage(Image, BackgroundWidth, BackgroundHeight, Scaled);
+
+			Path = GetCookedTexturePath(Source, BackgroundWidth, BackgroundHeight);
+			if (!WriteCookedTexture(Path, Scaled))
+			{
+				std::cerr << "Cooking failed, can not write " << Path << std::endl;
+				Failures++;
+				continue;
+			}
+
+			std::cout << Source << " -> " << Path << " (" << BackgroundWidth << "x" << BackgroundHeight << ")" << std::endl;
+			Bytes += Scaled.Pixels.size();
+		}
+	}
+
+	std::cout << "Cooked " << LevelCount << " levels and " << Textures.size() << " textures, " << Bytes / 1024 << " KiB of pixels, " << Failures << " failures" << std::endl;
+	return Failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "DdsLoader.h"
+#include <string>
+
+/* Directory cooked textures are written to, mirroring the source paths */
+extern const char* CookedRoot;
+
+/* Path of the cooked blob for a source texture. Width and Height of 0 name the native size blob, anything else a pre-scaled one. */
+std::string GetCookedTexturePath(const std::string& SourcePath, int Width = 0, int Height = 0);
+
+/* Path of the compiled image of a level document */
+std::string GetCookedLevelPath(const std::string& SourcePath);
+
+/* True if the cooked file exists and is not older than its source. A missing source counts as unchanged. */
+bool IsCookedUpToDate(const std::string& CookedPath, const std::string& SourcePath);
+
+/* Writes Image as a cooked blob: a small header with dimensions and pitch followed by the RGBA rows. Returns false on I/O failure. */
+bool WriteCookedTexture(const std::string& Path, const DecodedImage& Image);
+
+/* Reads the cooked blob of a source texture with a single read and no decoding.
+   Returns false without logging if there is no blob or it is older than the source, and logs if the blob is corrupt. */
+bool LoadCookedTexture(const std::string& SourcePath, DecodedImage& Image, int Width = 0, int Height = 0);
+
+/* Compiles every level under Assets/Levels to a binary image and decodes every DDS file under Assets/Textures and every texture the levels reference into cooked blobs.
+   With a window size the level backgrounds are also cooked pre-scaled to their on-screen size. Returns the process exit code. */
+int RunAssetCooker(int WindowWidth = 0, int WindowHeight = 0);
@@ -0,0 +1,40 @@
+#include "AssetName.h"
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+/* A deque keeps references to its elements valid while it grows */
+static std::mutex NamesMutex;
+static std::deque<std::string> Names(1);
+static std::unordered_map<std::string, unsigned int> Ids;
+
+AssetName::AssetName(const std::string& Path) :
+	Id(0)
+{
+	if (Path.empty()) return;
+
+	std::lock_guard<std::mutex> Lock(NamesMutex);
+	auto Found = Ids.find(Path);
+
+	if (Found != Ids.end())
+	{
+		Id = Found->second;
+		return;
+	}
+
+	Id = (unsigned int)Names.size();
+	Names.push_back(Path);
+	Ids.emplace(Path, Id);
+}
+
+const std::string& AssetName::GetPath() const
+{
+	std::lock_guard<std::mutex> Lock(NamesMutex);
+	return Names[Id];
+}
+
+void AssetHandleTable::Set(AssetName Name, int Handle)
+{
+	if (Name.GetId() >= Handles.size()) Handles.resize(Name.GetId() + 1, Unresolved);
+	Handles[Name.GetId()] = Handle;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/* Interned asset path. Every distinct path is stored once per process and names compare as integers.
+   Caches index their handles by the id instead of hashing the path again. Interning is thread safe, names are never freed. */
+class AssetName
+{
+
+private:
+    /* 0 is the empty path */
+    unsigned int Id;
+
+public:
+    AssetName() : Id(0) {}
+    explicit AssetName(const std::string& Path);
+
+    unsigned int GetId() const { return Id; }
+    bool IsEmpty() const { return Id == 0; }
+
+    /* The interned path. The reference stays valid for the life of the process. */
+    const std::string& GetPath() const;
+
+    bool operator==(AssetName Other) const { return Id == Other.Id; }
+    bool operator!=(AssetName Other) const { return Id != Other.Id; }
+};
+
+/* Handles of a cache indexed by AssetName id, so each name goes through the cache's path lookup only once */
+class AssetHandleTable
+{
+
+private:
+    /* Entry for a name that was not looked up yet */
+    static constexpr int Unresolved = -2;
+
+    std::vector<int> Handles;
+
+public:
+    /* Returns true and the stored handle if Name was set before */
+    bool Find(AssetName Name, int& Handle) const
+    {
+        if (Name.GetId() >= Handles.size() || Handles[Name.GetId()] == Unresolved) return false;
+        Handle = Handles[Name.GetId()];
+        return true;
+    }
+
+    /* Stores the handle of Name, including failure values like -1 */
+    void Set(AssetName Name, int Handle);
+
+    void Clear() { Handles.clear(); }
+};
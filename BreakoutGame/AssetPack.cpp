@@ -0,0 +1,221 @@
+#include "AssetPack.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+const char PackMagic[4] = { 'B', 'P', 'A', 'K' };
+const uint32_t PackVersion = 1;
+const uint64_t PackAlignment = 4096;
+
+/* Little endian on every supported platform. The table of contents follows the header, then the name strings, then the page aligned entries. */
+struct PackHeader
+{
+    char Magic[4];
+    uint32_t Version;
+    uint32_t EntryCount;
+    uint32_t NamesSize;
+};
+
+/* Sorted by name, compared bytewise */
+struct PackEntry
+{
+    uint32_t NameOffset;
+    uint32_t NameLength;
+    uint64_t Offset;
+    uint64_t Size;
+};
+
+const unsigned char* AssetPack::Base = nullptr;
+unsigned int AssetPack::EntryCount = 0;
+
+/* Owns the mapping behind Base */
+static MappedFile PackFile;
+
+static const PackEntry* GetEntries(const unsigned char* Base)
+{
+	return reinterpret_cast<const PackEntry*>(Base + sizeof(PackHeader));
+}
+
+static int CompareName(const unsigned char* Names, const PackEntry& Entry, const char* Path, size_t Length)
+{
+	int Result = std::memcmp(Names + Entry.NameOffset, Path, std::min<size_t>(Entry.NameLength, Length));
+	if (Result != 0) return Result;
+	return Entry.NameLength < Length ? -1 : (Entry.NameLength > Length ? 1 : 0);
+}
+
+/* Checks that the table of contents, names and entries all lie inside the mapping and the names are sorted */
+static bool ValidatePack(const unsigned char* Base, size_t Size)
+{
+	if (Size < sizeof(PackHeader)) return false;
+
+	const PackHeader* Header = reinterpret_cast<const PackHeader*>(Base);
+	if (std::memcmp(Header->Magic, PackMagic, sizeof(PackMagic)) != 0 || Header->Version != PackVersion) return false;
+
+	uint64_t NamesBegin = sizeof(PackHeader) + (uint64_t)Header->EntryCount * sizeof(PackEntry);
+	if (NamesBegin + Header->NamesSize > Size) return false;
+
+	const PackEntry* Entries = GetEntries(Base);
+	const unsigned char* Names = Base + NamesBegin;
+
+	for (uint32_t i = 0; i < Header->EntryCount; i++)
+	{
+		const PackEntry& Entry = Entries[i];
+		if ((uint64_t)Entry.NameOffset + Entry.NameLength > Header->NamesSize) return false;
+		if (Entry.Offset > Size || Entry.Size > Size - Entry.Offset) return false;
+
+		if (i > 0 && CompareName(Names, Entries[i - 1], (const char*)Names + Entry.NameOffset, Entry.NameLength) >= 0) return false;
+	}
+
+	return true;
+}
+
+bool AssetPack::Mount(const char* Path)
+{
+	Unmount();
+
+	if (!PackFile.Open(Path)) return false;
+
+	if (!ValidatePack(PackFile.GetData(), PackFile.GetSize()))
+	{
+		std::cerr << "Asset pack is corrupt: " << Path << std::endl;
+		PackFile.Close();
+		return false;
+	}
+
+	Base = PackFile.GetData();
+	EntryCount = reinterpret_cast<const PackHeader*>(Base)->EntryCount;
+	std::cout << "Mounted asset pack " << Path << " (" << EntryCount << " assets)" << std::endl;
+	return true;
+}
+
+void AssetPack::Unmount()
+{
+	PackFile.Close();
+	Base = nullptr;
+	EntryCount = 0;
+}
+
+bool AssetPack::Find(const char* Path, const unsigned char*& Data, size_t& Size)
+{
+	if (Base == nullptr) return false;
+
+	const PackEntry* Entries = GetEntries(Base);
+	const unsigned char* Names = reinterpret_cast<const unsigned char*>(Entries + EntryCount);
+	size_t Length = std::strlen(Path);
+
+	unsigned int Low = 0;
+	unsigned int High = EntryCount;
+
+	while (Low < High)
+	{
+		unsigned int Middle = Low + (High - Low) / 2;
+		int Result = CompareName(Names, Entries[Middle], Path, Length);
+
+		if (Result == 0)
+		{
+			Data = Base + Entries[Middle].Offset;
+			Size = (size_t)Entries[Middle].Size;
+			return true;
+		}
+
+		if (Result < 0) Low = Middle + 1;
+		else High = Middle;
+	}
+
+	return false;
+}
+
+int BuildAssetPack(const char* Path)
+{
+	std::vector<std::string> Files;
+	std::error_code Error;
+
+	for (const char* Root : { "Assets", "Cooked" })
+	{
+		for (const auto& Entry : std::filesystem::recursive_directory_iterator(Root, Error))
+		{
+			if (Entry.is_regular_file()) Files.push_back(Entry.path().generic_string());
+		}
+	}
+
+	std::sort(Files.begin(), Files.end());
+
+	std::vector<PackEntry> Entries(Files.size());
+	std::string Names;
+
+	for (size_t i = 0; i < Files.size(); i++)
+	{
+		Entries[i].NameOffset = (uint32_t)Names.size();
+		Entries[i].NameLength = (uint32_t)Files[i].size();
+		Names += Files[i];
+	}
+
+	PackHeader Header;
+	std::memcpy(Header.Magic, PackMagic, sizeof(PackMagic));
+	Header.Version = PackVersion;
+	Header.EntryCount = (uint32_t)Entries.size();
+	Header.NamesSize = (uint32_t)Names.size();
+
+	/* Page aligned entries let the loaders' reads map one to one onto shared pages */
+	uint64_t Offset = sizeof(PackHeader) + Entries.size() * sizeof(PackEntry) + Names.size();
+	for (size_t i = 0; i < Files.size(); i++)
+	{
+		Offset = (Offset + PackAlignment - 1) / PackAlignment * PackAlignment;
+		Entries[i].Offset = Offset;
+		Entries[i].Size = (uint64_t)std::filesystem::file_size(Files[i], Error);
+		if (Error)
+		{
+			std::cerr << "Packing failed, can not read " << Files[i] << std::endl;
+			return 1;
+		}
+
+		Offset += Entries[i].Size;
+	}
+
+	std::ofstream Pack(Path, std::ios::binary | std::ios::trunc);
+	if (!Pack)
+	{
+		std::cerr << "Packing failed, can not write " << Path << std::endl;
+		return 1;
+	}
+
+	Pack.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+	Pack.write(reinterpret_cast<const char*>(Entries.data()), Entries.size() * sizeof(PackEntry));
+	Pack.write(Names.data(), Names.size());
+
+	std::vector<char> Data;
+	uint64_t Written = sizeof(PackHeader) + Entries.size() * sizeof(PackEntry) + Names.size();
+	const std::vector<char> Padding((size_t)PackAlignment, 0);
+
+	for (size_t i = 0; i < Files.size(); i++)
+	{
+		std::ifstream File(Files[i], std::ios::binary);
+		Data.resize((size_t)Entries[i].Size);
+
+		if (!File.read(Data.data(), Data.size()))
+		{
+			std::cerr << "Packing failed, can not read " << Files[i] << std::endl;
+			return 1;
+		}
+
+		Pack.write(Padding.data(), (std::streamsize)(Entries[i].Offset - Written));
+		Pack.write(Data.data(), Data.size());
+		Written = Entries[i].Offset + Entries[i].Size;
+	}
+
+	if (!Pack)
+	{
+		std::cerr << "Packing failed, can not write " << Path << std::endl;
+		return 1;
+	}
+
+	std::cout << "Packed " << Files.size() << " assets into " << Path << " (" << Offset / 1024 << " KiB)" << std::endl;
+	return 0;
+}
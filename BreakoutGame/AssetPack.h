@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+
+/* Read-only view of a pack file holding all assets, mapped into memory once at startup.
+   Loaders look up the path they would otherwise open and consume the bytes straight from the mapping,
+   so a mounted pack costs no file syscalls per asset and its pages are shared by every process mapping the same file. */
+class AssetPack
+{
+
+private:
+    /* Start of the mapped pack, null while no pack is mounted */
+    static const unsigned char* Base;
+    static unsigned int EntryCount;
+
+public:
+    /* Maps the pack at Path. Returns false without logging if there is no such file and logs if it can not be mapped or is corrupt. */
+    static bool Mount(const char* Path);
+
+    /* Unmaps the pack. Every pointer returned by Find becomes invalid. */
+    static void Unmount();
+
+    static bool IsMounted() { return Base != nullptr; }
+
+    /* Looks up an asset by the path it is loaded from, e.g. "Assets/Sounds/HitWall.wav", with a binary search of the table of contents.
+       Returns false if no pack is mounted or the pack does not contain the asset. */
+    static bool Find(const char* Path, const unsigned char*& Data, size_t& Size);
+};
+
+/* Writes every file under Assets and Cooked into a pack at Path with a sorted table of contents and page aligned entries.
+   Returns the process exit code. */
+int BuildAssetPack(const char* Path);
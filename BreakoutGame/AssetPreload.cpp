@@ -0,0 +1,97 @@
+#include "AssetPreload.h"
+#include "AssetPack.h"
+#include "Profiler.h"
+#include "TextureCache.h"
+#include <fstream>
+#include <unordered_set>
+
+/* Appends Path unless it is empty or already listed */
+static void AddUnique(const std::string& Path, std::unordered_set<std::string>& Seen, std::vector<std::string>& Paths)
+{
+	if (!Path.empty() && Seen.insert(Path).second) Paths.push_back(Path);
+}
+
+static void ReadSoundFile(const std::string& Path, std::vector<unsigned char>& Data)
+{
+	const unsigned char* Packed;
+	size_t PackedSize;
+	if (AssetPack::Find(Path.c_str(), Packed, PackedSize)) return;
+
+	std::ifstream File(Path, std::ios::binary | std::ios::ate);
+	if (!File) return;
+
+	std::streamoff Size = File.tellg();
+	if (Size <= 0) return;
+
+	Data.resize((size_t)Size);
+	File.seekg(0);
+	if (!File.read((char*)Data.data(), Size)) Data.clear();
+}
+
+void PreloadAssets(ThreadPool& Pool, const std::vector<const char*>& LevelPaths, const std::vector<std::string>& FixedSprites,
+	const std::vector<std::string>& FixedSounds, PreloadedAssets& Result)
+{
+	PROFILE_ZONE("PreloadAssets");
+
+	/* The levels name the remaining assets, so they are parsed first */
+	Result.Levels.assign(LevelPaths.size(), nullptr);
+
+	Pool.ParallelFor((int)LevelPaths.size(), 1, [&](int Begin, int End)
+	{
+		for (int i = Begin; i < End; i++)
+		{
+			auto Level = std::make_shared<LevelData>();
+			if (LoadLevel(LevelPaths[i], *Level)) Result.Levels[i] = Level;
+		}
+	});
+
+	std::unordered_set<std::string> Seen;
+	for (const std::string& Path : FixedSprites) AddUnique(Path, Seen, Result.SpritePaths);
+	for (const std::string& Path : FixedSounds) AddUnique(Path, Seen, Result.SoundPaths);
+
+	for (const auto& Level : Result.Levels)
+	{
+		if (!Level) continue;
+
+		AddUnique(Level->BackgroundPath.GetPath(), Seen, Result.BackgroundPaths);
+
+		for (const BrickType& Type : Level->BrickTypes)
+		{
+			AddUnique(Type.Texture.GetPath(), Seen, Result.SpritePaths);
+			AddUnique(Type.HitSound.GetPath(), Seen, Result.SoundPaths);
+			AddUnique(Type.BreakSound.GetPath(), Seen, Result.SoundPaths);
+		}
+	}
+
+	Result.SpriteImages.resize(Result.SpritePaths.size());
+	Result.BackgroundImages.resize(Result.BackgroundPaths.size());
+	Result.SoundFiles.resize(Result.SoundPaths.size());
+
+	/* One job per asset, the large backgrounds first so they do not end up last on a single thread */
+	int BackgroundCount = (int)Result.BackgroundPaths.size();
+	int SpriteCount = (int)Result.SpritePaths.size();
+	int SoundCount = (int)Result.SoundPaths.size();
+
+	Pool.ParallelFor(BackgroundCount + SpriteCount + SoundCount, 1, [&](int Begin, int End)
+	{
+		for (int i = Begin; i < End; i++)
+		{
+			if (i < BackgroundCount)
+			{
+				if (!DecodeTextureFile(Result.BackgroundPaths[i], Result.BackgroundImages[i])) Result.BackgroundImages[i] = DecodedImage();
+			}
+
+			else if (i < BackgroundCount + SpriteCount)
+			{
+				int Sprite = i - BackgroundCount;
+				if (!DecodeTextureFile(Result.SpritePaths[Sprite], Result.SpriteImages[Sprite])) Result.SpriteImages[Sprite] = DecodedImage();
+			}
+
+			else
+			{
+				int Sound = i - BackgroundCount - SpriteCount;
+				ReadSoundFile(Result.SoundPaths[Sound], Result.SoundFiles[Sound]);
+			}
+		}
+	});
+}
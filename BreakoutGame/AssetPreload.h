@@ -0,0 +1,31 @@
+#pragma once
+#include "DdsLoader.h"
+#include "LevelData.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Everything a set of levels references, loaded off the main thread and ready to be uploaded */
+struct PreloadedAssets
+{
+    /* Parallel to the level paths, null for levels that failed to load */
+    std::vector<std::shared_ptr<const LevelData>> Levels;
+
+    /* Textures drawn through the sprite atlas: the fixed sprites and every brick texture. Empty images failed to decode. */
+    std::vector<std::string> SpritePaths;
+    std::vector<DecodedImage> SpriteImages;
+
+    /* Level backgrounds, drawn as whole textures */
+    std::vector<std::string> BackgroundPaths;
+    std::vector<DecodedImage> BackgroundImages;
+
+    /* Raw sound files. Empty for sounds held by the mounted asset pack, which are read from the mapping instead, and for unreadable files. */
+    std::vector<std::string> SoundPaths;
+    std::vector<std::vector<unsigned char>> SoundFiles;
+};
+
+/* Parses all levels, then decodes every texture and reads every sound they and the fixed assets reference, spread over the threads of Pool.
+   Each path is loaded once. Nothing here touches SDL, so the caller uploads the results on the thread that owns the renderer. */
+void PreloadAssets(ThreadPool& Pool, const std::vector<const char*>& LevelPaths, const std::vector<std::string>& FixedSprites,
+    const std::vector<std::string>& FixedSounds, PreloadedAssets& Result);
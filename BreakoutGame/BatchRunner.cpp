@@ -0,0 +1,73 @@
+#include "BatchRunner.h"
+#include "Profiler.h"
+#include <memory>
+
+BatchRunner::BatchRunner(int GameCount, const std::vector<const char*>& LevelPaths, int ThreadCount) :
+	Games(GameCount),
+	Pool(ThreadCount),
+	ChunkSize(64)
+{
+	std::vector<std::shared_ptr<const LevelData>> Levels;
+
+	for (const char* Path : LevelPaths)
+	{
+		auto Level = std::make_shared<LevelData>();
+		LoadLevel(Path, *Level);
+		Levels.push_back(Level);
+	}
+
+	for (GameSimulation& Game : Games)
+	{
+		Game.Init(LevelPaths);
+
+		for (int i = 0; i < (int)Levels.size(); i++)
+		{
+			Game.SetLevel(i, Levels[i]);
+		}
+	}
+
+	Reset();
+}
+
+void BatchRunner::Reset()
+{
+	Pool.ParallelFor(GetGameCount(), ChunkSize, [&](int Begin, int End)
+	{
+		for (int i = Begin; i < End; i++)
+		{
+			Games[i].ClearGameOver();
+			Games[i].ResetGame();
+			Games[i].ClearEvents();
+		}
+	});
+}
+
+void BatchRunner::Step(const float* PaddleX, float TimeStep, float* Rewards, int* Lives, unsigned char* Done)
+{
+	Pool.ParallelFor(GetGameCount(), ChunkSize, [&](int Begin, int End)
+	{
+		PROFILE_ZONE("BatchRunner::Step");
+
+		for (int i = Begin; i < End; i++)
+		{
+			GameSimulation& Game = Games[i];
+			if (Game.IsPaused()) Game.Release();
+
+			int ScoreBefore = Game.GetScore();
+			Game.Update(PaddleX[i], TimeStep);
+			Game.ClearEvents();
+
+			/* Outputs describe the step that was just simulated, a finished game is restarted only afterwards */
+			Rewards[i] = (float)(Game.GetScore() - ScoreBefore);
+			Lives[i] = Game.GetLives();
+			Done[i] = Game.IsGameOver() ? 1 : 0;
+
+			if (Game.IsGameOver())
+			{
+				Game.ClearGameOver();
+				Game.ResetGame();
+				Game.ClearEvents();
+			}
+		}
+	});
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "GameSimulation.h"
+#include "ThreadPool.h"
+#include <vector>
+
+/* Steps many independent games in lockstep on all cores. The levels are loaded once and shared by every game. */
+class BatchRunner
+{
+
+private:
+    std::vector<GameSimulation> Games;
+    ThreadPool Pool;
+
+    /* Games stepped by one task. Small enough to balance, large enough to keep queue traffic low. */
+    int ChunkSize;
+
+public:
+    /* ThreadCount 0 uses one thread per hardware thread */
+    BatchRunner(int GameCount, const std::vector<const char*>& LevelPaths, int ThreadCount = 0);
+
+    int GetGameCount() const { return (int)Games.size(); }
+    int GetThreadCount() const { return Pool.GetThreadCount(); }
+    const GameSimulation& GetGame(int Index) const { return Games[Index]; }
+
+    /* Starts a new game in every slot */
+    void Reset();
+
+    /* Advances every game by TimeStep. PaddleX holds one paddle position in world units per game.
+       Writes the score gained during the step to Rewards, the remaining lives to Lives and 1 to Done for games that ended.
+       Rewards and Lives of a finished game describe its last step. Paused games are released automatically and finished games are restarted afterwards. */
+    void Step(const float* PaddleX, float TimeStep, float* Rewards, int* Lives, unsigned char* Done);
+};
@@ -0,0 +1,465 @@
+#include "Benchmark.h"
+#include "BatchRunner.h"
+#include "BrickSweep.h"
+#include "DdsLoader.h"
+#include "LevelImage.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#ifdef _WIN32
+#include "DirectXTex.h"
+#endif
+
+/* Fills a Rows x Columns layout with bricks of the same size the game uses, leaving roughly a quarter of the cells empty */
+static void MakeSyntheticLayout(BrickStore& Bricks, int Rows, int Columns, std::mt19937& Random)
+{
+	const float Spacing = 0.0011875f;
+	const float BrickWidth = (0.9f - (Columns + 1) * Spacing) / Columns;
+	const float BrickHeight = 0.03125f;
+
+	Bricks.Init(Rows, Columns);
+	std::uniform_int_distribution<int> Cell(0, 3);
+
+	for (int Row = 0; Row < Rows; Row++)
+	{
+		for (int Column = 0; Column < Columns; Column++)
+		{
+			if (Cell(Random) == 0) continue;
+
+			float MinX = 0.05f + Column * BrickWidth + (Column + 1) * Spacing;
+			float MinY = 0.2f + Row * (BrickHeight + 0.0022875f);
+			Bricks.Add(Row, Column, MinX, MinY, MinX + BrickWidth, MinY + BrickHeight, 1, 0);
+		}
+	}
+}
+
+int RunSweepBenchmark()
+{
+	const int Layouts[][2] = { { 100, 100 }, { 1000, 100 }, { 1000, 1000 } };
+	const int SweepCount = 200;
+
+	SweepBricksFunction Kernels[] = { SweepBricksScalar, SweepBricksSse, SweepBricksAvx };
+	int KernelCount = GetSweepBricks() == SweepBricksAvx ? 3 : (GetSweepBricks() == SweepBricksSse ? 2 : 1);
+
+	std::mt19937 Random(12345);
+	int Mismatches = 0;
+
+	for (const auto& Layout : Layouts)
+	{
+		BrickStore Bricks;
+		MakeSyntheticLayout(Bricks, Layout[0], Layout[1], Random);
+
+		/* Random cubes inside the layout, swept far enough to cross most of it */
+		std::uniform_real_distribution<float> Position(0.05f, 0.95f);
+		std::uniform_real_distribution<float> Angle(0, 6.2831853f);
+		float LayoutHeight = Layout[0] * (0.03125f + 0.0022875f);
+
+		std::vector<SweepInput> Sweeps;
+		for (int i = 0; i < SweepCount; i++)
+		{
+			float X = Position(Random);
+			float Y = 0.2f + Position(Random) * LayoutHeight;
+			float A = Angle(Random);
+			Sweeps.push_back(MakeSweepInput(X - 0.0075f, Y - 0.01f, X + 0.0075f, Y + 0.01f, std::cos(A), std::sin(A)));
+		}
+
+		std::vector<SweepHit> Reference;
+		std::cout << "Layout " << Layout[0] << " x " << Layout[1] << " (" << Bricks.Count << " bricks)" << std::endl;
+
+		for (int k = 0; k < KernelCount; k++)
+		{
+			auto Start = std::chrono::steady_clock::now();
+			std::vector<SweepHit> Hits;
+
+			for (const SweepInput& Sweep : Sweeps)
+			{
+				SweepHit Hit = { LayoutHeight * 2, -1, 0 };
+				Kernels[k](Bricks, 0, Bricks.Size() - 1, Sweep, Hit);
+				Hits.push_back(Hit);
+			}
+
+			double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+			double NanosecondsPerSlot = Seconds * 1e9 / (double(Bricks.Size()) * SweepCount);
+			std::cout << "  " << GetSweepBricksName(Kernels[k]) << ": " << Seconds * 1000 / SweepCount << " ms per sweep, " << NanosecondsPerSlot << " ns per brick" << std::endl;
+
+			if (k == 0)
+			{
+				Reference = Hits;
+				continue;
+			}
+
+			for (int i = 0; i < SweepCount; i++)
+			{
+				if (Hits[i].Index != Reference[i].Index || Hits[i].Time != Reference[i].Time || Hits[i].Axis != Reference[i].Axis) Mismatches++;
+			}
+		}
+	}
+
+	if (Mismatches > 0)
+	{
+		std::cerr << Mismatches << " sweeps differ from the scalar kernel" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+int RunBatchBenchmark(int GameCount, int StepCount)
+{
+	const float TimeStep = 1.0f / 60.0f;
+
+	BatchRunner Batch(GameCount, { "Assets/Levels/Level1.xml", "Assets/Levels/Level2.xml", "Assets/Levels/Level3.xml" });
+
+	std::vector<float> PaddleX(GameCount);
+	std::vector<float> Rewards(GameCount);
+	std::vector<int> Lives(GameCount);
+	std::vector<unsigned char> Done(GameCount);
+	std::vector<unsigned int> Seeds(GameCount);
+
+	for (int i = 0; i < GameCount; i++)
+	{
+		Seeds[i] = i + 1;
+	}
+
+	long long GamesFinished = 0;
+	double TotalReward = 0.0;
+
+	auto Start = std::chrono::steady_clock::now();
+
+	for (int Step = 0; Step < StepCount; Step++)
+	{
+		/* Same autopilot as the headless mode: follow the cube with an offset that changes every 97 steps */
+		for (int i = 0; i < GameCount; i++)
+		{
+			if (Step % 97 == 0) Seeds[i] = Seeds[i] * 1103515245u + 12345u;
+			float Offset = PaddleSize.x * (((Seeds[i] >> 16) & 0xFF) / 255.0f - 0.5f);
+			PaddleX[i] = Batch.GetGame(i).GetCube().x + Offset;
+		}
+
+		Batch.Step(PaddleX.data(), TimeStep, Rewards.data(), Lives.data(), Done.data());
+
+		for (int i = 0; i < GameCount; i++)
+		{
+			GamesFinished += Done[i];
+			TotalReward += Rewards[i];
+		}
+	}
+
+	double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	double GameSteps = (double)GameCount * StepCount;
+
+	std::cout << "Batch: " << GameCount << " games, " << StepCount << " steps, " << Batch.GetThreadCount() << " threads" << std::endl;
+	std::cout << "  " << Seconds << " s, " << GameSteps / Seconds / 1e6 << " M game steps/s" << std::endl;
+	std::cout << "  Games finished " << GamesFinished << ", total reward " << TotalReward << std::endl;
+
+	return 0;
+}
+
+/* Builds a DDS file with a legacy FourCC header and random block data */
+static std::vector<unsigned char> MakeSyntheticBlockDds(const char* FourCC, int Width, int Height, std::mt19937& Random)
+{
+	size_t BlockSize = strcmp(FourCC, "DXT1") == 0 ? 8 : 16;
+	size_t DataSize = (size_t)((Width + 3) / 4) * ((Height + 3) / 4) * BlockSize;
+	std::vector<unsigned char> File(128 + DataSize, 0);
+
+	uint32_t Header[] = { 0x20534444, 124, 0x1007, (uint32_t)Height, (uint32_t)Width };
+	memcpy(File.data(), Header, sizeof(Header));
+	uint32_t PixelFormat[] = { 32, 0x4 };
+	memcpy(File.data() + 76, PixelFormat, sizeof(PixelFormat));
+	memcpy(File.data() + 84, FourCC, 4);
+
+	for (size_t i = 128; i < File.size(); i++)
+	{
+		File[i] = (unsigned char)Random();
+	}
+
+	return File;
+}
+
+static bool ReadFile(const char* Path, std::vector<unsigned char>& Data)
+{
+	std::ifstream File(Path, std::ios::binary);
+	if (!File) return false;
+
+	Data.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+	return true;
+}
+
+int RunDdsBenchmark()
+{
+	const char* ShippedFiles[] =
+	{
+		"Assets/Textures/Boards/Board_01.dds",
+		"Assets/Textures/Boards/Board_02.dds",
+		"Assets/Textures/Border/Border.dds",
+		"Assets/Textures/Bricks/Hard.dds",
+		"Assets/Textures/Bricks/Impenetrable.dds",
+		"Assets/Textures/Bricks/Medium.dds",
+		"Assets/Textures/Bricks/Soft.dds",
+		"Assets/Textures/Cube/Cube.dds",
+		"Assets/Textures/Paddle/Paddle.dds"
+	};
+
+	const int Passes = 50;
+
+	DdsDecoder Decoders[] = { DdsDecoderScalar, DdsDecoderSse2, DdsDecoderAvx2 };
+	int DecoderCount = GetDdsDecoder() == DdsDecoderAvx2 ? 3 : (GetDdsDecoder() == DdsDecoderSse2 ? 2 : 1);
+
+	std::mt19937 Random(12345);
+	std::vector<std::vector<unsigned char>> Shipped;
+	std::vector<std::vector<unsigned char>> Synthetic;
+
+	for (const char* Path : ShippedFiles)
+	{
+		std::vector<unsigned char> Data;
+		if (!ReadFile(Path, Data))
+		{
+			std::cerr << "Reading " << Path << " failed" << std::endl;
+			return 1;
+		}
+
+		Shipped.push_back(std::move(Data));
+	}
+
+	/* Odd sizes cover the partial blocks on the right and bottom edge */
+	Synthetic.push_back(MakeSyntheticBlockDds("DXT1", 1024, 1024, Random));
+	Synthetic.push_back(MakeSyntheticBlockDds("DXT3", 1024, 1024, Random));
+	Synthetic.push_back(MakeSyntheticBlockDds("DXT5", 1024, 1024, Random));
+	Synthetic.push_back(MakeSyntheticBlockDds("DXT1", 250, 130, Random));
+	Synthetic.push_back(MakeSyntheticBlockDds("DXT5", 250, 130, Random));
+
+	int Mismatches = 0;
+	const std::vector<std::vector<unsigned char>>* Sets[] = { &Shipped, &Synthetic };
+	const char* SetNames[] = { "Shipped files", "Synthetic BC1-BC3" };
+
+	for (int Set = 0; Set < 2; Set++)
+	{
+		const std::vector<std::vector<unsigned char>>& Files = *Sets[Set];
+		size_t Bytes = 0;
+		for (const auto& File : Files) Bytes += File.size();
+
+		std::cout << SetNames[Set] << " (" << Files.size() << " files, " << Bytes / 1024 << " KB)" << std::endl;
+		std::vector<DecodedImage> Reference(Files.size());
+
+		for (int d = 0; d < DecoderCount; d++)
+		{
+			std::vector<DecodedImage> Images(Files.size());
+			auto Start = std::chrono::steady_clock::now();
+
+			for (int Pass = 0; Pass < Passes; Pass++)
+			{
+				for (size_t i = 0; i < Files.size(); i++)
+				{
+					if (!DecodeDds(Files[i].data(), Files[i].size(), Images[i], Decoders[d])) Mismatches++;
+				}
+			}
+
+			double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+			std::cout << "  " << GetDdsDecoderName(Decoders[d]) << ": " << Seconds * 1000 / Passes << " ms per pass, " << Bytes * Passes / Seconds / (1024 * 1024) << " MB/s" << std::endl;
+
+			if (d == 0)
+			{
+				Reference = std::move(Images);
+				continue;
+			}
+
+			for (size_t i = 0; i < Files.size(); i++)
+			{
+				if (Images[i].Pixels != Reference[i].Pixels) Mismatches++;
+			}
+		}
+
+#ifdef _WIN32
+		auto Start = std::chrono::steady_clock::now();
+
+		for (int Pass = 0; Pass < Passes; Pass++)
+		{
+			for (const auto& File : Files)
+			{
+				DirectX::TexMetadata MetaData;
+				DirectX::ScratchImage ScratchImage;
+				DirectX::LoadFromDDSMemory(File.data(), File.size(), DirectX::DDS_FLAGS_NONE, &MetaData, ScratchImage);
+
+				/* Block compressed files have to be decompressed to be comparable */
+				if (DirectX::IsCompressed(MetaData.format))
+				{
+					DirectX::ScratchImage Decompressed;
+					DirectX::Decompress(ScratchImage.GetImages(), ScratchImage.GetImageCount(), MetaData, DXGI_FORMAT_R8G8B8A8_UNORM, Decompressed);
+				}
+			}
+		}
+
+		double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+		std::cout << "  DirectXTex: " << Seconds * 1000 / Passes << " ms per pass, " << Bytes * Passes / Seconds / (1024 * 1024) << " MB/s" << std::endl;
+#endif
+	}
+
+	/* Whole load including file reads, as TextureCache does it */
+	auto Start = std::chrono::steady_clock::now();
+
+	for (int Pass = 0; Pass < Passes; Pass++)
+	{
+		for (const char* Path : ShippedFiles)
+		{
+			DecodedImage Image;
+			if (!LoadDdsFile(Path, Image)) Mismatches++;
+		}
+	}
+
+	double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	std::cout << "LoadDdsFile on shipped files: " << Seconds * 1000 / Passes << " ms per pass" << std::endl;
+
+	if (Mismatches > 0)
+	{
+		std::cerr << Mismatches << " images failed to decode or differ from the scalar decoder" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
+
+/* Writes a level document in the shipped format with a Rows x Columns layout of the shipped brick types and roughly a quarter empty cells */
+static std::string MakeSyntheticLevelXml(int Rows, int Columns, std::mt19937& Random)
+{
+	std::string Text =
+		"<Level RowCount=\"" + std::to_string(Rows) + "\" ColumnCount=\"" + std::to_string(Columns) + "\" RowSpacing=\"3\" ColumnSpacing=\"3\" BackgroundTexture=\"Assets/Textures/Boards/Board_01.dds\">\n"
+		"\t<BrickTypes>\n"
+		"\t\t<BrickType Id=\"S\" Texture=\"Assets/Textures/Bricks/Soft.dds\" HitPoints=\"1\" HitSound=\"Assets/Sounds/Hit_01.wav\" BreakSound=\"Assets/Sounds/Break_01.wav\" BreakScore=\"50\" />\n"
+		"\t\t<BrickType Id=\"M\" Texture=\"Assets/Textures/Bricks/Medium.dds\" HitPoints=\"2\" HitSound=\"Assets/Sounds/Hit_01.wav\" BreakSound=\"Assets/Sounds/Break_01.wav\" BreakScore=\"100\" />\n"
+		"\t\t<BrickType Id=\"H\" Texture=\"Assets/Textures/Bricks/Hard.dds\" HitPoints=\"3\" HitSound=\"Assets/Sounds/Hit_01.wav\" BreakSound=\"Assets/Sounds/Break_01.wav\" BreakScore=\"150\" />\n"
+		"\t\t<BrickType Id=\"I\" Texture=\"Assets/Textures/Bricks/Impenetrable.dds\" HitPoints=\"Infinite\" HitSound=\"Assets/Sounds/Hit_02.wav\" />\n"
+		"\t</BrickTypes>\n"
+		"<Bricks>\n";
+
+	const char Cells[] = { '_', '_', 'S', 'M', 'H', 'I', 'S', 'M' };
+	std::uniform_int_distribution<int> Cell(0, 7);
+	Text.reserve(Text.size() + (size_t)Rows * Columns * 2 + 32);
+
+	for (int Row = 0; Row < Rows; Row++)
+	{
+		for (int Column = 0; Column < Columns; Column++)
+		{
+			Text += Cells[Cell(Random)];
+			Text += Column + 1 < Columns ? ' ' : '\n';
+		}
+	}
+
+	Text += "</Bricks>\n</Level>\n";
+	return Text;
+}
+
+static bool LevelsEqual(const LevelData& A, const LevelData& B)
+{
+	if (A.RowCount != B.RowCount || A.ColumnCount != B.ColumnCount || A.RowSpacing != B.RowSpacing || A.ColumnSpacing != B.ColumnSpacing) return false;
+	if (A.BackgroundPath != B.BackgroundPath || A.BrickTypes.size() != B.BrickTypes.size()) return false;
+	if (A.BricksLayout.Width != B.BricksLayout.Width || A.BricksLayout.Height != B.BricksLayout.Height || A.BricksLayout.Cells != B.BricksLayout.Cells) return false;
+
+	for (size_t i = 0; i < A.BrickTypes.size(); i++)
+	{
+		const BrickType& TypeA = A.BrickTypes[i];
+		const BrickType& TypeB = B.BrickTypes[i];
+		if (TypeA.Id != TypeB.Id || TypeA.Texture != TypeB.Texture || TypeA.HitSound != TypeB.HitSound || TypeA.BreakSound != TypeB.BreakSound) return false;
+		if (TypeA.HitPoints != TypeB.HitPoints || TypeA.BreakScore != TypeB.BreakScore) return false;
+	}
+
+	return true;
+}
+
+int RunLevelBenchmark()
+{
+	const int Layouts[][2] = { { 15, 2 }, { 100, 100 }, { 1000, 1000 } };
+	const int Passes = 10;
+	const char* ImagePath = "LevelBenchmark.lvl";
+
+	std::mt19937 Random(12345);
+	int Mismatches = 0;
+
+	for (const auto& Layout : Layouts)
+	{
+		std::string Xml = MakeSyntheticLevelXml(Layout[0], Layout[1], Random);
+
+		LevelData Reference;
+		if (!ParseLevel(Xml.data(), Xml.size(), Reference))
+		{
+			std::cerr << "Parsing the synthetic level failed" << std::endl;
+			return 1;
+		}
+
+		std::vector<unsigned char> Compiled;
+		CompileLevel(Reference, Compiled);
+
+		std::ofstream Output(ImagePath, std::ios::binary | std::ios::trunc);
+		Output.write(reinterpret_cast<const char*>(Compiled.data()), Compiled.size());
+		Output.close();
+
+		std::cout << Layout[0] << "x" << Layout[1] << " level (XML " << Xml.size() / 1024 << " KB, compiled " << Compiled.size() / 1024 << " KB)" << std::endl;
+
+		/* XML from memory, as LoadLevel does for a packed document */
+		auto Start = std::chrono::steady_clock::now();
+		for (int Pass = 0; Pass < Passes; Pass++)
+		{
+			LevelData Level;
+			if (!ParseLevel(Xml.data(), Xml.size(), Level)) Mismatches++;
+		}
+
+		double XmlSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count() / Passes;
+
+		/* Mapping and validating the compiled image, after which every cell is readable in place */
+		Start = std::chrono::steady_clock::now();
+		for (int Pass = 0; Pass < Passes; Pass++)
+		{
+			MappedFile File;
+			LevelImage Image;
+			if (!File.Open(ImagePath) || !Image.Init(File.GetData(), File.GetSize()))
+			{
+				Mismatches++;
+				continue;
+			}
+
+			if (Image.GetCell(Image.GetHeader().LayoutHeight - 1, Image.GetHeader().LayoutWidth - 1) != Reference.BricksLayout.At(Reference.BricksLayout.Height - 1, Reference.BricksLayout.Width - 1)) Mismatches++;
+		}
+
+		double ViewSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count() / Passes;
+
+		/* Mapping plus the copy into the LevelData the simulation plays */
+		Start = std::chrono::steady_clock::now();
+		for (int Pass = 0; Pass < Passes; Pass++)
+		{
+			MappedFile File;
+			LevelImage Image;
+			LevelData Level;
+			if (!File.Open(ImagePath) || !Image.Init(File.GetData(), File.GetSize()))
+			{
+				Mismatches++;
+				continue;
+			}
+
+			Image.ToLevelData(Level);
+			if (Pass == 0 && !LevelsEqual(Level, Reference)) Mismatches++;
+		}
+
+		double LoadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count() / Passes;
+
+		std::cout << "  XML parse: " << XmlSeconds * 1000 << " ms" << std::endl;
+		std::cout << "  Compiled map and validate: " << ViewSeconds * 1000 << " ms (" << XmlSeconds / ViewSeconds << "x)" << std::endl;
+		std::cout << "  Compiled map and copy to LevelData: " << LoadSeconds * 1000 << " ms (" << XmlSeconds / LoadSeconds << "x)" << std::endl;
+	}
+
+	std::remove(ImagePath);
+
+	if (Mismatches > 0)
+	{
+		std::cerr << Mismatches << " compiled levels failed to load or differ from the XML document" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+/* Sweeps a cube against large synthetic brick layouts with every available kernel, checks that all kernels agree and prints their timings */
+int RunSweepBenchmark();
+
+/* Runs GameCount autopiloted games in lockstep for StepCount steps on all cores and prints the simulation throughput */
+int RunBatchBenchmark(int GameCount, int StepCount);
+
+/* Decodes every shipped DDS file and synthetic BC1 to BC3 images with every available decoder, checks that all decoders agree and prints their timings.
+   On Windows DirectXTex is timed on the same files for comparison. */
+int RunDdsBenchmark();
+
+/* Parses synthetic level documents of up to 1000x1000 cells as XML and loads their compiled images, checks that both agree and prints their timings */
+int RunLevelBenchmark();
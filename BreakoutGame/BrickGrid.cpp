@@ -0,0 +1,78 @@
+#include "BrickGrid.h"
+#include <algorithm>
+#include <cmath>
+
+/* Widens every query so bricks touching a cell boundary are not missed because of rounding */
+const float QueryEpsilon = 0.0001f;
+
+BrickGrid::BrickGrid() :
+	Rows(0),
+	Columns(0),
+	OriginX(0),
+	OriginY(0),
+	CellWidth(1),
+	CellHeight(1)
+{
+}
+
+void BrickGrid::Init(int Rows, int Columns, float OriginX, float OriginY, float CellWidth, float CellHeight)
+{
+	this->Rows = Rows;
+	this->Columns = Columns;
+	this->OriginX = OriginX;
+	this->OriginY = OriginY;
+	this->CellWidth = CellWidth;
+	this->CellHeight = CellHeight;
+}
+
+void BrickGrid::Query(float MinX, float MinY, float MaxX, float MaxY, float DirectionX, float DirectionY, float Distance, std::vector<BrickSpan>& Result) const
+{
+	Result.clear();
+	if (Rows == 0 || Columns == 0) return;
+
+	MinX -= QueryEpsilon;
+	MinY -= QueryEpsilon;
+	MaxX += QueryEpsilon;
+	MaxY += QueryEpsilon;
+
+	float SweptMinY = std::min(MinY, MinY + DirectionY * Distance);
+	float SweptMaxY = std::max(MaxY, MaxY + DirectionY * Distance);
+
+	int FirstRow = std::max((int)std::floor((SweptMinY - OriginY) / CellHeight), 0);
+	int LastRow = std::min((int)std::floor((SweptMaxY - OriginY) / CellHeight), Rows - 1);
+
+	for (int Row = FirstRow; Row <= LastRow; Row++)
+	{
+		float RowMin = OriginY + Row * CellHeight;
+		float RowMax = RowMin + CellHeight;
+
+		/* Part of the sweep during which the box overlaps this row */
+		float Enter = 0;
+		float Exit = Distance;
+
+		if (DirectionY > 0)
+		{
+			Enter = std::max(Enter, (RowMin - MaxY) / DirectionY);
+			Exit = std::min(Exit, (RowMax - MinY) / DirectionY);
+		}
+
+		else if (DirectionY < 0)
+		{
+			Enter = std::max(Enter, (RowMax - MinY) / DirectionY);
+			Exit = std::min(Exit, (RowMin - MaxY) / DirectionY);
+		}
+
+		if (Enter > Exit) continue;
+
+		float SpanMinX = MinX + DirectionX * (DirectionX > 0 ? Enter : Exit);
+		float SpanMaxX = MaxX + DirectionX * (DirectionX > 0 ? Exit : Enter);
+
+		int FirstColumn = std::max((int)std::floor((SpanMinX - OriginX) / CellWidth), 0);
+		int LastColumn = std::min((int)std::floor((SpanMaxX - OriginX) / CellWidth), Columns - 1);
+
+		if (FirstColumn <= LastColumn)
+		{
+			Result.push_back({ Row * Columns + FirstColumn, Row * Columns + LastColumn });
+		}
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+
+/* Range of consecutive cell indices in row-major order, both ends inclusive */
+struct BrickSpan
+{
+    int First;
+    int Last;
+};
+
+/* Geometry of the level layout. Cell indices match the slots of BrickStore. */
+class BrickGrid
+{
+
+private:
+    int Rows;
+    int Columns;
+
+    /* Top left corner of the first cell and distance between neighbouring cells */
+    float OriginX;
+    float OriginY;
+    float CellWidth;
+    float CellHeight;
+
+public:
+    BrickGrid();
+
+    void Init(int Rows, int Columns, float OriginX, float OriginY, float CellWidth, float CellHeight);
+
+    /* Collects the cells touched by the box [MinX, MinY] - [MaxX, MaxY] moving Distance along (DirectionX, DirectionY).
+       The rows crossed by the sweep are walked one by one and one span per row holds the columns the box covers inside that row. */
+    void Query(float MinX, float MinY, float MaxX, float MaxY, float DirectionX, float DirectionY, float Distance, std::vector<BrickSpan>& Result) const;
+};
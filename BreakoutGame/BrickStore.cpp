@@ -0,0 +1,48 @@
+#include "BrickStore.h"
+#include <cstddef>
+#include <limits>
+
+/* An inverted infinite box, every time of hit against it is infinite or negative */
+const float EmptyMin = std::numeric_limits<float>::infinity();
+const float EmptyMax = -std::numeric_limits<float>::infinity();
+
+void BrickStore::Init(int Rows, int Columns)
+{
+	this->Rows = Rows;
+	this->Columns = Columns;
+	Count = 0;
+
+	size_t Slots = size_t(Rows) * Columns;
+	MinX.assign(Slots, EmptyMin);
+	MinY.assign(Slots, EmptyMin);
+	MaxX.assign(Slots, EmptyMax);
+	MaxY.assign(Slots, EmptyMax);
+	HitPoints.assign(Slots, 0);
+	TypeIndex.assign(Slots, EmptyBrickType);
+}
+
+void BrickStore::Add(int Row, int Column, float MinX, float MinY, float MaxX, float MaxY, int HitPoints, unsigned char TypeIndex)
+{
+	size_t Index = size_t(Row) * Columns + Column;
+	if (!IsAlive((int)Index)) Count++;
+
+	this->MinX[Index] = MinX;
+	this->MinY[Index] = MinY;
+	this->MaxX[Index] = MaxX;
+	this->MaxY[Index] = MaxY;
+	this->HitPoints[Index] = HitPoints;
+	this->TypeIndex[Index] = TypeIndex;
+}
+
+void BrickStore::Remove(int Index)
+{
+	if (!IsAlive(Index)) return;
+	Count--;
+
+	MinX[Index] = EmptyMin;
+	MinY[Index] = EmptyMin;
+	MaxX[Index] = EmptyMax;
+	MaxY[Index] = EmptyMax;
+	HitPoints[Index] = 0;
+	TypeIndex[Index] = EmptyBrickType;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+
+/* Type index of a cell without a brick */
+const unsigned char EmptyBrickType = 0xFF;
+
+/* Bricks of the current level stored as parallel arrays in row-major layout order, one slot per layout cell.
+   The collision loop only streams the box arrays; everything else about a brick is looked up through its type index. */
+struct BrickStore
+{
+    int Rows = 0;
+    int Columns = 0;
+
+    /* Number of bricks that are still in the game */
+    int Count = 0;
+
+    std::vector<float> MinX;
+    std::vector<float> MinY;
+    std::vector<float> MaxX;
+    std::vector<float> MaxY;
+    std::vector<int> HitPoints;
+    std::vector<unsigned char> TypeIndex;
+
+    /* Resizes the store to Rows x Columns empty slots */
+    void Init(int Rows, int Columns);
+
+    /* Places a brick in the slot of the given layout cell */
+    void Add(int Row, int Column, float MinX, float MinY, float MaxX, float MaxY, int HitPoints, unsigned char TypeIndex);
+
+    /* Removes a brick. The slot keeps an empty box so it can never be hit again. */
+    void Remove(int Index);
+
+    bool IsAlive(int Index) const { return TypeIndex[Index] != EmptyBrickType; }
+
+    /* Number of slots */
+    int Size() const { return Rows * Columns; }
+};
@@ -0,0 +1,310 @@
+#include "BrickSweep.h"
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BRICKSWEEP_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BRICKSWEEP_AVX_TARGET
+#else
+#include <cpuid.h>
+#define BRICKSWEEP_AVX_TARGET __attribute__((target("avx")))
+#endif
+#endif
+
+const float NoHit = std::numeric_limits<float>::infinity();
+
+SweepInput MakeSweepInput(float CubeMinX, float CubeMinY, float CubeMaxX, float CubeMaxY, float DirectionX, float DirectionY)
+{
+	SweepInput Input;
+	Input.CubeMinX = CubeMinX;
+	Input.CubeMinY = CubeMinY;
+	Input.CubeMaxX = CubeMaxX;
+	Input.CubeMaxY = CubeMaxY;
+	Input.DirectionX = DirectionX;
+	Input.DirectionY = DirectionY;
+	Input.InverseDirectionX = DirectionX != 0 ? 1.0f / DirectionX : 0;
+	Input.InverseDirectionY = DirectionY != 0 ? 1.0f / DirectionY : 0;
+	return Input;
+}
+
+void SweepBricksScalar(const BrickStore& Bricks, int First, int Last, const SweepInput& Input, SweepHit& Hit)
+{
+	const float* MinX = Bricks.MinX.data();
+	const float* MinY = Bricks.MinY.data();
+	const float* MaxX = Bricks.MaxX.data();
+	const float* MaxY = Bricks.MaxY.data();
+
+	for (int i = First; i <= Last; i++)
+	{
+		if (Input.DirectionX != 0)
+		{
+			float TimeOfHit = Input.DirectionX > 0 ? (MinX[i] - Input.CubeMaxX) * Input.InverseDirectionX : (MaxX[i] - Input.CubeMinX) * Input.InverseDirectionX;
+			if ((TimeOfHit >= 0) && (TimeOfHit < Hit.Time))
+			{
+				float NewCubeMin = Input.CubeMinY + Input.DirectionY * TimeOfHit;
+				float NewCubeMax = Input.CubeMaxY + Input.DirectionY * TimeOfHit;
+
+				if ((NewCubeMax >= MinY[i]) && (MaxY[i] >= NewCubeMin))
+				{
+					Hit.Time = TimeOfHit;
+					Hit.Index = i;
+					Hit.Axis = 0;
+				}
+			}
+		}
+
+		if (Input.DirectionY != 0)
+		{
+			float TimeOfHit = Input.DirectionY > 0 ? (MinY[i] - Input.CubeMaxY) * Input.InverseDirectionY : (MaxY[i] - Input.CubeMinY) * Input.InverseDirectionY;
+			if ((TimeOfHit >= 0) && (TimeOfHit < Hit.Time))
+			{
+				float NewCubeMin = Input.CubeMinX + Input.DirectionX * TimeOfHit;
+				float NewCubeMax = Input.CubeMaxX + Input.DirectionX * TimeOfHit;
+
+				if ((NewCubeMax >= MinX[i]) && (MaxX[i] >= NewCubeMin))
+				{
+					Hit.Time = TimeOfHit;
+					Hit.Index = i;
+					Hit.Axis = 1;
+				}
+			}
+		}
+	}
+}
+
+#ifdef BRICKSWEEP_X86
+
+/* Picks the earliest of the per lane results. Lanes only hold slots of a sequential scan,
+   so on equal times the lowest slot wins, exactly like in SweepBricksScalar. */
+static void ReduceLanes(const float* Times, const int* Indices, const int* Axes, int LaneCount, SweepHit& Hit)
+{
+	for (int Lane = 0; Lane < LaneCount; Lane++)
+	{
+		if (Indices[Lane] == -1) continue;
+
+		if (Times[Lane] < Hit.Time || (Times[Lane] == Hit.Time && Indices[Lane] < Hit.Index))
+		{
+			Hit.Time = Times[Lane];
+			Hit.Index = Indices[Lane];
+			Hit.Axis = Axes[Lane];
+		}
+	}
+}
+
+static inline __m128 Select(__m128 Mask, __m128 A, __m128 B)
+{
+	return _mm_or_ps(_mm_and_ps(Mask, A), _mm_andnot_ps(Mask, B));
+}
+
+void SweepBricksSse(const BrickStore& Bricks, int First, int Last, const SweepInput& Input, SweepHit& Hit)
+{
+	const float* MinX = Bricks.MinX.data();
+	const float* MinY = Bricks.MinY.data();
+	const float* MaxX = Bricks.MaxX.data();
+	const float* MaxY = Bricks.MaxY.data();
+
+	const __m128 Zero = _mm_setzero_ps();
+	const __m128 Infinity = _mm_set1_ps(NoHit);
+	const __m128 CubeMinX = _mm_set1_ps(Input.CubeMinX);
+	const __m128 CubeMinY = _mm_set1_ps(Input.CubeMinY);
+	const __m128 CubeMaxX = _mm_set1_ps(Input.CubeMaxX);
+	const __m128 CubeMaxY = _mm_set1_ps(Input.CubeMaxY);
+	const __m128 DirectionX = _mm_set1_ps(Input.DirectionX);
+	const __m128 DirectionY = _mm_set1_ps(Input.DirectionY);
+	const __m128 InverseDirectionX = _mm_set1_ps(Input.InverseDirectionX);
+	const __m128 InverseDirectionY = _mm_set1_ps(Input.InverseDirectionY);
+
+	__m128 BestTime = _mm_set1_ps(Hit.Time);
+	__m128i BestIndex = _mm_set1_epi32(-1);
+	__m128i BestAxis = _mm_setzero_si128();
+	__m128i Index = _mm_setr_epi32(First, First + 1, First + 2, First + 3);
+	const __m128i Step = _mm_set1_epi32(4);
+	const __m128i AxisY = _mm_set1_epi32(1);
+
+	int i = First;
+	for (; i + 3 <= Last; i += 4)
+	{
+		__m128 BrickMinX = _mm_loadu_ps(MinX + i);
+		__m128 BrickMinY = _mm_loadu_ps(MinY + i);
+		__m128 BrickMaxX = _mm_loadu_ps(MaxX + i);
+		__m128 BrickMaxY = _mm_loadu_ps(MaxY + i);
+
+		__m128 TimeX = Infinity;
+		if (Input.DirectionX != 0)
+		{
+			__m128 Time = Input.DirectionX > 0 ? _mm_mul_ps(_mm_sub_ps(BrickMinX, CubeMaxX), InverseDirectionX) : _mm_mul_ps(_mm_sub_ps(BrickMaxX, CubeMinX), InverseDirectionX);
+			__m128 NewCubeMin = _mm_add_ps(CubeMinY, _mm_mul_ps(DirectionY, Time));
+			__m128 NewCubeMax = _mm_add_ps(CubeMaxY, _mm_mul_ps(DirectionY, Time));
+			__m128 Valid = _mm_and_ps(_mm_cmpge_ps(Time, Zero), _mm_and_ps(_mm_cmpge_ps(NewCubeMax, BrickMinY), _mm_cmpge_ps(BrickMaxY, NewCubeMin)));
+			TimeX = Select(Valid, Time, Infinity);
+		}
+
+		__m128 TimeY = Infinity;
+		if (Input.DirectionY != 0)
+		{
+			__m128 Time = Input.DirectionY > 0 ? _mm_mul_ps(_mm_sub_ps(BrickMinY, CubeMaxY), InverseDirectionY) : _mm_mul_ps(_mm_sub_ps(BrickMaxY, CubeMinY), InverseDirectionY);
+			__m128 NewCubeMin = _mm_add_ps(CubeMinX, _mm_mul_ps(DirectionX, Time));
+			__m128 NewCubeMax = _mm_add_ps(CubeMaxX, _mm_mul_ps(DirectionX, Time));
+			__m128 Valid = _mm_and_ps(_mm_cmpge_ps(Time, Zero), _mm_and_ps(_mm_cmpge_ps(NewCubeMax, BrickMinX), _mm_cmpge_ps(BrickMaxX, NewCubeMin)));
+			TimeY = Select(Valid, Time, Infinity);
+		}
+
+		/* A horizontal face only wins over a vertical face of the same brick if it is hit strictly earlier */
+		__m128 UseY = _mm_cmplt_ps(TimeY, TimeX);
+		__m128 Time = Select(UseY, TimeY, TimeX);
+		__m128 Better = _mm_cmplt_ps(Time, BestTime);
+
+		BestTime = Select(Better, Time, BestTime);
+		BestIndex = _mm_castps_si128(Select(Better, _mm_castsi128_ps(Index), _mm_castsi128_ps(BestIndex)));
+		BestAxis = _mm_castps_si128(Select(Better, _mm_and_ps(UseY, _mm_castsi128_ps(AxisY)), _mm_castsi128_ps(BestAxis)));
+		Index = _mm_add_epi32(Index, Step);
+	}
+
+	float Times[4];
+	int Indices[4];
+	int Axes[4];
+	_mm_storeu_ps(Times, BestTime);
+	_mm_storeu_si128((__m128i*)Indices, BestIndex);
+	_mm_storeu_si128((__m128i*)Axes, BestAxis);
+	ReduceLanes(Times, Indices, Axes, 4, Hit);
+
+	/* The remaining slots come after all vector lanes, so a sequential scan keeps the order */
+	if (i <= Last) SweepBricksScalar(Bricks, i, Last, Input, Hit);
+}
+
+BRICKSWEEP_AVX_TARGET static inline __m256 Select(__m256 Mask, __m256 A, __m256 B)
+{
+	return _mm256_or_ps(_mm256_and_ps(Mask, A), _mm256_andnot_ps(Mask, B));
+}
+
+BRICKSWEEP_AVX_TARGET void SweepBricksAvx(const BrickStore& Bricks, int First, int Last, const SweepInput& Input, SweepHit& Hit)
+{
+	const float* MinX = Bricks.MinX.data();
+	const float* MinY = Bricks.MinY.data();
+	const float* MaxX = Bricks.MaxX.data();
+	const float* MaxY = Bricks.MaxY.data();
+
+	const __m256 Zero = _mm256_setzero_ps();
+	const __m256 Infinity = _mm256_set1_ps(NoHit);
+	const __m256 CubeMinX = _mm256_set1_ps(Input.CubeMinX);
+	const __m256 CubeMinY = _mm256_set1_ps(Input.CubeMinY);
+	const __m256 CubeMaxX = _mm256_set1_ps(Input.CubeMaxX);
+	const __m256 CubeMaxY = _mm256_set1_ps(Input.CubeMaxY);
+	const __m256 DirectionX = _mm256_set1_ps(Input.DirectionX);
+	const __m256 DirectionY = _mm256_set1_ps(Input.DirectionY);
+	const __m256 InverseDirectionX = _mm256_set1_ps(Input.InverseDirectionX);
+	const __m256 InverseDirectionY = _mm256_set1_ps(Input.InverseDirectionY);
+
+	/* AVX has no 256 bit integer arithmetic, so slots are tracked as floats. They are exact up to 2^24 slots. */
+	__m256 BestTime = _mm256_set1_ps(Hit.Time);
+	__m256 BestIndex = _mm256_set1_ps(-1);
+	__m256 BestAxis = Zero;
+	__m256 Index = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256 Step = _mm256_set1_ps(8);
+	const __m256 AxisY = _mm256_set1_ps(1);
+	Index = _mm256_add_ps(Index, _mm256_set1_ps((float)First));
+
+	int i = First;
+	for (; i + 7 <= Last; i += 8)
+	{
+		__m256 BrickMinX = _mm256_loadu_ps(MinX + i);
+		__m256 BrickMinY = _mm256_loadu_ps(MinY + i);
+		__m256 BrickMaxX = _mm256_loadu_ps(MaxX + i);
+		__m256 BrickMaxY = _mm256_loadu_ps(MaxY + i);
+
+		__m256 TimeX = Infinity;
+		if (Input.DirectionX != 0)
+		{
+			__m256 Time = Input.DirectionX > 0 ? _mm256_mul_ps(_mm256_sub_ps(BrickMinX, CubeMaxX), InverseDirectionX) : _mm256_mul_ps(_mm256_sub_ps(BrickMaxX, CubeMinX), InverseDirectionX);
+			__m256 NewCubeMin = _mm256_add_ps(CubeMinY, _mm256_mul_ps(DirectionY, Time));
+			__m256 NewCubeMax = _mm256_add_ps(CubeMaxY, _mm256_mul_ps(DirectionY, Time));
+			__m256 Valid = _mm256_and_ps(_mm256_cmp_ps(Time, Zero, _CMP_GE_OQ), _mm256_and_ps(_mm256_cmp_ps(NewCubeMax, BrickMinY, _CMP_GE_OQ), _mm256_cmp_ps(BrickMaxY, NewCubeMin, _CMP_GE_OQ)));
+			TimeX = Select(Valid, Time, Infinity);
+		}
+
+		__m256 TimeY = Infinity;
+		if (Input.DirectionY != 0)
+		{
+			__m256 Time = Input.DirectionY > 0 ? _mm256_mul_ps(_mm256_sub_ps(BrickMinY, CubeMaxY), InverseDirectionY) : _mm256_mul_ps(_mm256_sub_ps(BrickMaxY, CubeMinY), InverseDirectionY);
+			__m256 NewCubeMin = _mm256_add_ps(CubeMinX, _mm256_mul_ps(DirectionX, Time));
+			__m256 NewCubeMax = _mm256_add_ps(CubeMaxX, _mm256_mul_ps(DirectionX, Time));
+			__m256 Valid = _mm256_and_ps(_mm256_cmp_ps(Time, Zero, _CMP_GE_OQ), _mm256_and_ps(_mm256_cmp_ps(NewCubeMax, BrickMinX, _CMP_GE_OQ), _mm256_cmp_ps(BrickMaxX, NewCubeMin, _CMP_GE_OQ)));
+			TimeY = Select(Valid, Time, Infinity);
+		}
+
+		/* A horizontal face only wins over a vertical face of the same brick if it is hit strictly earlier */
+		__m256 UseY = _mm256_cmp_ps(TimeY, TimeX, _CMP_LT_OQ);
+		__m256 Time = Select(UseY, TimeY, TimeX);
+		__m256 Better = _mm256_cmp_ps(Time, BestTime, _CMP_LT_OQ);
+
+		BestTime = Select(Better, Time, BestTime);
+		BestIndex = Select(Better, Index, BestIndex);
+		BestAxis = Select(Better, _mm256_and_ps(UseY, AxisY), BestAxis);
+		Index = _mm256_add_ps(Index, Step);
+	}
+
+	float Times[8];
+	float LaneIndices[8];
+	float LaneAxes[8];
+	_mm256_storeu_ps(Times, BestTime);
+	_mm256_storeu_ps(LaneIndices, BestIndex);
+	_mm256_storeu_ps(LaneAxes, BestAxis);
+
+	int Indices[8];
+	int Axes[8];
+	for (int Lane = 0; Lane < 8; Lane++)
+	{
+		Indices[Lane] = (int)LaneIndices[Lane];
+		Axes[Lane] = (int)LaneAxes[Lane];
+	}
+
+	ReduceLanes(Times, Indices, Axes, 8, Hit);
+
+	/* The remaining slots come after all vector lanes, so a sequential scan keeps the order */
+	if (i <= Last) SweepBricksScalar(Bricks, i, Last, Input, Hit);
+}
+
+static bool CpuSupportsAvx()
+{
+#ifdef _MSC_VER
+	int Info[4];
+	__cpuid(Info, 1);
+	bool bOsSavesYmm = (Info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+	return bOsSavesYmm && (Info[2] & (1 << 28)) != 0;
+#else
+	return __builtin_cpu_supports("avx");
+#endif
+}
+
+#else
+
+void SweepBricksSse(const BrickStore& Bricks, int First, int Last, const SweepInput& Input, SweepHit& Hit)
+{
+	SweepBricksScalar(Bricks, First, Last, Input, Hit);
+}
+
+void SweepBricksAvx(const BrickStore& Bricks, int First, int Last, const SweepInput& Input, SweepHit& Hit)
+{
+	SweepBricksScalar(Bricks, First, Last, Input, Hit);
+}
+
+#endif
+
+SweepBricksFunction GetSweepBricks()
+{
+#ifdef BRICKSWEEP_X86
+	static const SweepBricksFunction Function = CpuSupportsAvx() ? SweepBricksAvx : SweepBricksSse;
+#else
+	static const SweepBricksFunction Function = SweepBricksScalar;
+#endif
+	return Function;
+}
+
+const char* GetSweepBricksName(SweepBricksFunction Function)
+{
+	if (Function == SweepBricksAvx) return "AVX";
+	if (Function == SweepBricksSse) return "SSE";
+	return "Scalar";
+}
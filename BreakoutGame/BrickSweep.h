@@ -0,0 +1,45 @@
+#pragma once
+#include "BrickStore.h"
+
+/* Cube box and direction of one sweep. Inverse directions are only read for non-zero directions. */
+struct SweepInput
+{
+    float CubeMinX;
+    float CubeMinY;
+    float CubeMaxX;
+    float CubeMaxY;
+    float DirectionX;
+    float DirectionY;
+    float InverseDirectionX;
+    float InverseDirectionY;
+};
+
+/* Earliest hit found so far. Time starts at the time allowed for the sweep and Index at -1. */
+struct SweepHit
+{
+    float Time;
+    int Index;
+
+    /* 0 if a vertical face was hit and the cube bounces in x, 1 if a horizontal face was hit and it bounces in y */
+    int Axis;
+};
+
+/* Sweeps the cube against the bricks in slots [First, Last] and replaces Hit with any hit earlier than Hit.Time.
+   Equal times keep the hit with the lower slot, so all kernels return the same result as a sequential scan. */
+typedef void (*SweepBricksFunction)(const BrickStore& Bricks, int First, int Last, const SweepInput& Input, SweepHit& Hit);
+
+SweepInput MakeSweepInput(float CubeMinX, float CubeMinY, float CubeMaxX, float CubeMaxY, float DirectionX, float DirectionY);
+
+void SweepBricksScalar(const BrickStore& Bricks, int First, int Last, const SweepInput& Input, SweepHit& Hit);
+
+/* Four bricks per instruction. Only available on x86 and x64 builds. */
+void SweepBricksSse(const BrickStore& Bricks, int First, int Last, const SweepInput& Input, SweepHit& Hit);
+
+/* Eight bricks per instruction. Must only be called when the CPU and OS support AVX. */
+void SweepBricksAvx(const BrickStore& Bricks, int First, int Last, const SweepInput& Input, SweepHit& Hit);
+
+/* Returns the fastest kernel supported by the CPU, detected once on the first call */
+SweepBricksFunction GetSweepBricks();
+
+/* Name of a kernel for logging */
+const char* GetSweepBricksName(SweepBricksFunction Function);
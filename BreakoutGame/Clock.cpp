@@ -0,0 +1,14 @@
+#include "Clock.h"
+#include "SDL.h"
+
+PerformanceClock::PerformanceClock() :
+	StartCounter(SDL_GetPerformanceCounter()),
+	SecondsPerCount(1.0 / (double)SDL_GetPerformanceFrequency())
+{
+}
+
+double PerformanceClock::Now() const
+{
+	/* Counting from StartCounter keeps the value small, so the double keeps its sub-microsecond precision */
+	return (double)(SDL_GetPerformanceCounter() - StartCounter) * SecondsPerCount;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+/* Monotonic time source. The main loop and the HUD clock read time only through a Clock, so they can be driven by a FakeClock. */
+class Clock
+{
+
+public:
+    virtual ~Clock() {}
+
+    /* Seconds since an arbitrary fixed point, never decreasing */
+    virtual double Now() const = 0;
+};
+
+/* High resolution wall clock based on SDL_GetPerformanceCounter. Resolution is well below a microsecond on all desktop platforms. */
+class PerformanceClock : public Clock
+{
+
+private:
+    unsigned long long StartCounter;
+    double SecondsPerCount;
+
+public:
+    PerformanceClock();
+
+    double Now() const override;
+};
+
+/* Clock that only moves when told to, for headless runs and benchmarks that need reproducible time */
+class FakeClock : public Clock
+{
+
+private:
+    double Time;
+
+public:
+    FakeClock() : Time(0) {}
+
+    double Now() const override { return Time; }
+
+    /* Moves the clock forward. Negative values are ignored so the clock stays monotonic. */
+    void Advance(double Seconds) { if (Seconds > 0) Time += Seconds; }
+};
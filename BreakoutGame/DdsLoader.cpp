@@ -0,0 +1,585 @@
+#include "DdsLoader.h"
+#include "AssetPack.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DDSLOADER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define DDSLOADER_AVX2_TARGET
+#else
+#include <cpuid.h>
+#define DDSLOADER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+const uint32_t DdsMagic = 0x20534444; // "DDS "
+const size_t DdsHeaderSize = 4 + 124;
+const size_t Dx10HeaderSize = 20;
+
+const uint32_t PixelFormatAlphaPixels = 0x1;
+const uint32_t PixelFormatFourCC = 0x4;
+const uint32_t PixelFormatRgb = 0x40;
+
+enum DdsFormat
+{
+	FormatUnsupported,
+	FormatRgb32,
+	FormatBc1,
+	FormatBc2,
+	FormatBc3
+};
+
+/* How the bytes of an uncompressed pixel map to RGBA */
+enum Swizzle
+{
+	SwizzleCopy,
+	SwizzleSetAlpha,
+	SwizzleSwapRedBlue,
+	SwizzleSwapRedBlueSetAlpha,
+	SwizzleGeneric
+};
+
+struct ChannelShifts
+{
+	int Red;
+	int Green;
+	int Blue;
+
+	/* -1 when the file has no alpha */
+	int Alpha;
+};
+
+static uint32_t ReadU32(const unsigned char* Data)
+{
+	uint32_t Value;
+	memcpy(&Value, Data, 4);
+	return Value;
+}
+
+static uint32_t MakeFourCC(char a, char b, char c, char d)
+{
+	return (uint32_t)(unsigned char)a | ((uint32_t)(unsigned char)b << 8) | ((uint32_t)(unsigned char)c << 16) | ((uint32_t)(unsigned char)d << 24);
+}
+
+/* Returns the bit shift of a single byte mask, or -1 if the mask is not one whole byte */
+static int MaskShift(uint32_t Mask)
+{
+	for (int Shift = 0; Shift < 32; Shift += 8)
+	{
+		if (Mask == (0xFFu << Shift)) return Shift;
+	}
+
+	return -1;
+}
+
+/* Scalar reference kernels */
+
+static void ConvertRowScalar(const uint32_t* Source, uint32_t* Destination, int Count, Swizzle Mode, const ChannelShifts& Shifts)
+{
+	for (int i = 0; i < Count; i++)
+	{
+		uint32_t Pixel = Source[i];
+
+		switch (Mode)
+		{
+		case SwizzleCopy:
+			Destination[i] = Pixel;
+			break;
+
+		case SwizzleSetAlpha:
+			Destination[i] = Pixel | 0xFF000000u;
+			break;
+
+		case SwizzleSwapRedBlue:
+			Destination[i] = (Pixel & 0xFF00FF00u) | ((Pixel >> 16) & 0xFFu) | ((Pixel & 0xFFu) << 16);
+			break;
+
+		case SwizzleSwapRedBlueSetAlpha:
+			Destination[i] = (Pixel & 0x0000FF00u) | ((Pixel >> 16) & 0xFFu) | ((Pixel & 0xFFu) << 16) | 0xFF000000u;
+			break;
+
+		default:
+			Destination[i] = ((Pixel >> Shifts.Red) & 0xFFu) | (((Pixel >> Shifts.Green) & 0xFFu) << 8) | (((Pixel >> Shifts.Blue) & 0xFFu) << 16)
+				| (Shifts.Alpha < 0 ? 0xFF000000u : ((Pixel >> Shifts.Alpha) & 0xFFu) << 24);
+			break;
+		}
+	}
+}
+
+/* Writes the palette color of every 2 bit index of a BC color block */
+static void ExpandIndicesScalar(uint32_t Indices, const uint32_t Palette[4], uint32_t Out[16])
+{
+	for (int i = 0; i < 16; i++)
+	{
+		Out[i] = Palette[(Indices >> (2 * i)) & 3];
+	}
+}
+
+/* Puts 16 alpha values into the alpha byte of the decoded block */
+static void MergeAlphaScalar(const unsigned char Alpha[16], uint32_t Out[16])
+{
+	for (int i = 0; i < 16; i++)
+	{
+		Out[i] = (Out[i] & 0x00FFFFFFu) | ((uint32_t)Alpha[i] << 24);
+	}
+}
+
+#ifdef DDSLOADER_X86
+
+/* SSE2 kernels, four pixels per instruction */
+
+static void ConvertRowSse2(const uint32_t* Source, uint32_t* Destination, int Count, Swizzle Mode, const ChannelShifts& Shifts)
+{
+	if (Mode == SwizzleGeneric)
+	{
+		ConvertRowScalar(Source, Destination, Count, Mode, Shifts);
+		return;
+	}
+
+	bool bSwap = Mode == SwizzleSwapRedBlue || Mode == SwizzleSwapRedBlueSetAlpha;
+	bool bSetAlpha = Mode == SwizzleSetAlpha || Mode == SwizzleSwapRedBlueSetAlpha;
+	const __m128i GreenAlpha = _mm_set1_epi32((int)0xFF00FF00u);
+	const __m128i RedBlue = _mm_set1_epi32(0x00FF00FF);
+	const __m128i Opaque = _mm_set1_epi32((int)0xFF000000u);
+
+	int i = 0;
+	for (; i + 4 <= Count; i += 4)
+	{
+		__m128i Pixels = _mm_loadu_si128((const __m128i*)(Source + i));
+
+		if (bSwap)
+		{
+			__m128i Swapped = _mm_and_si128(Pixels, RedBlue);
+			Swapped = _mm_or_si128(_mm_slli_epi32(Swapped, 16), _mm_srli_epi32(Swapped, 16));
+			Pixels = _mm_or_si128(_mm_and_si128(Pixels, GreenAlpha), Swapped);
+		}
+
+		if (bSetAlpha) Pixels = _mm_or_si128(Pixels, Opaque);
+		_mm_storeu_si128((__m128i*)(Destination + i), Pixels);
+	}
+
+	ConvertRowScalar(Source + i, Destination + i, Count - i, Mode, Shifts);
+}
+
+static void MergeAlphaSse2(const unsigned char Alpha[16], uint32_t Out[16])
+{
+	const __m128i Zero = _mm_setzero_si128();
+	const __m128i ColorMask = _mm_set1_epi32(0x00FFFFFF);
+	__m128i Bytes = _mm_loadu_si128((const __m128i*)Alpha);
+	__m128i Low = _mm_unpacklo_epi8(Bytes, Zero);
+	__m128i High = _mm_unpackhi_epi8(Bytes, Zero);
+	__m128i Words[4] = { _mm_unpacklo_epi16(Low, Zero), _mm_unpackhi_epi16(Low, Zero), _mm_unpacklo_epi16(High, Zero), _mm_unpackhi_epi16(High, Zero) };
+
+	for (int i = 0; i < 4; i++)
+	{
+		__m128i Color = _mm_and_si128(_mm_loadu_si128((const __m128i*)(Out + 4 * i)), ColorMask);
+		_mm_storeu_si128((__m128i*)(Out + 4 * i), _mm_or_si128(Color, _mm_slli_epi32(Words[i], 24)));
+	}
+}
+
+/* AVX2 kernels, eight pixels per instruction */
+
+DDSLOADER_AVX2_TARGET static void ConvertRowAvx2(const uint32_t* Source, uint32_t* Destination, int Count, Swizzle Mode, const ChannelShifts& Shifts)
+{
+	if (Mode == SwizzleGeneric)
+	{
+		ConvertRowScalar(Source, Destination, Count, Mode, Shifts);
+		return;
+	}
+
+	bool bSwap = Mode == SwizzleSwapRedBlue || Mode == SwizzleSwapRedBlueSetAlpha;
+	bool bSetAlpha = Mode == SwizzleSetAlpha || Mode == SwizzleSwapRedBlueSetAlpha;
+	const __m256i GreenAlpha = _mm256_set1_epi32((int)0xFF00FF00u);
+	const __m256i RedBlue = _mm256_set1_epi32(0x00FF00FF);
+	const __m256i Opaque = _mm256_set1_epi32((int)0xFF000000u);
+
+	int i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		__m256i Pixels = _mm256_loadu_si256((const __m256i*)(Source + i));
+
+		if (bSwap)
+		{
+			__m256i Swapped = _mm256_and_si256(Pixels, RedBlue);
+			Swapped = _mm256_or_si256(_mm256_slli_epi32(Swapped, 16), _mm256_srli_epi32(Swapped, 16));
+			Pixels = _mm256_or_si256(_mm256_and_si256(Pixels, GreenAlpha), Swapped);
+		}
+
+		if (bSetAlpha) Pixels = _mm256_or_si256(Pixels, Opaque);
+		_mm256_storeu_si256((__m256i*)(Destination + i), Pixels);
+	}
+
+	ConvertRowSse2(Source + i, Destination + i, Count - i, Mode, Shifts);
+}
+
+DDSLOADER_AVX2_TARGET static void ExpandIndicesAvx2(uint32_t Indices, const uint32_t Palette[4], uint32_t Out[16])
+{
+	/* Variable shifts bring the index of every pixel to the low bits of its lane, two rows at a time,
+	   then a lane permute looks the colors up in the palette held in the low four lanes */
+	const __m256i Shifts = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+	const __m256i Three = _mm256_set1_epi32(3);
+	__m256i Colors = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)Palette));
+
+	for (int Half = 0; Half < 2; Half++)
+	{
+		__m256i Lanes = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)(Indices >> (16 * Half))), Shifts), Three);
+		_mm256_storeu_si256((__m256i*)(Out + 8 * Half), _mm256_permutevar8x32_epi32(Colors, Lanes));
+	}
+}
+
+DDSLOADER_AVX2_TARGET static void MergeAlphaAvx2(const unsigned char Alpha[16], uint32_t Out[16])
+{
+	const __m256i ColorMask = _mm256_set1_epi32(0x00FFFFFF);
+	__m128i Bytes = _mm_loadu_si128((const __m128i*)Alpha);
+
+	for (int Half = 0; Half < 2; Half++)
+	{
+		__m256i Words = _mm256_cvtepu8_epi32(Half == 0 ? Bytes : _mm_srli_si128(Bytes, 8));
+		__m256i Color = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(Out + 8 * Half)), ColorMask);
+		_mm256_storeu_si256((__m256i*)(Out + 8 * Half), _mm256_or_si256(Color, _mm256_slli_epi32(Words, 24)));
+	}
+}
+
+static bool CpuSupportsAvx2()
+{
+#ifdef _MSC_VER
+	int Info[4];
+	__cpuid(Info, 1);
+	bool bOsSavesYmm = (Info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+	__cpuidex(Info, 7, 0);
+	return bOsSavesYmm && (Info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+struct DecoderKernels
+{
+	void (*ConvertRow)(const uint32_t* Source, uint32_t* Destination, int Count, Swizzle Mode, const ChannelShifts& Shifts);
+	void (*ExpandIndices)(uint32_t Indices, const uint32_t Palette[4], uint32_t Out[16]);
+	void (*MergeAlpha)(const unsigned char Alpha[16], uint32_t Out[16]);
+};
+
+static DecoderKernels GetKernels(DdsDecoder Decoder)
+{
+#ifdef DDSLOADER_X86
+	if (Decoder == DdsDecoderAvx2) return { ConvertRowAvx2, ExpandIndicesAvx2, MergeAlphaAvx2 };
+	/* SSE2 has no variable shuffle, compare and select over the four palette entries measured slower than plain table lookups */
+	if (Decoder == DdsDecoderSse2) return { ConvertRowSse2, ExpandIndicesScalar, MergeAlphaSse2 };
+#endif
+	return { ConvertRowScalar, ExpandIndicesScalar, MergeAlphaScalar };
+}
+
+static uint32_t ExpandColor565(uint16_t Color)
+{
+	uint32_t Red = (Color >> 11) & 0x1F;
+	uint32_t Green = (Color >> 5) & 0x3F;
+	uint32_t Blue = Color & 0x1F;
+	Red = (Red << 3) | (Red >> 2);
+	Green = (Green << 2) | (Green >> 4);
+	Blue = (Blue << 3) | (Blue >> 2);
+	return Red | (Green << 8) | (Blue << 16) | 0xFF000000u;
+}
+
+/* Mixes two colors channel by channel as (WeightA * A + WeightB * B) / Divisor. The divisor is a compile time constant so it becomes a multiply. */
+template <uint32_t WeightA, uint32_t WeightB, uint32_t Divisor>
+static uint32_t MixColors(uint32_t A, uint32_t B)
+{
+	uint32_t Red = ((A & 0xFF) * WeightA + (B & 0xFF) * WeightB) / Divisor;
+	uint32_t Green = (((A >> 8) & 0xFF) * WeightA + ((B >> 8) & 0xFF) * WeightB) / Divisor;
+	uint32_t Blue = (((A >> 16) & 0xFF) * WeightA + ((B >> 16) & 0xFF) * WeightB) / Divisor;
+	return Red | (Green << 8) | (Blue << 16) | 0xFF000000u;
+}
+
+/* Decodes the color half of a BC block. BC1 switches to three colors plus transparent black when Color0 <= Color1. */
+static void DecodeColorBlock(const unsigned char* Block, bool bAllowTransparent, const DecoderKernels& Kernels, uint32_t Out[16])
+{
+	uint16_t Color0 = (uint16_t)(Block[0] | (Block[1] << 8));
+	uint16_t Color1 = (uint16_t)(Block[2] | (Block[3] << 8));
+	uint32_t Palette[4];
+	Palette[0] = ExpandColor565(Color0);
+	Palette[1] = ExpandColor565(Color1);
+
+	if (Color0 > Color1 || !bAllowTransparent)
+	{
+		Palette[2] = MixColors<2, 1, 3>(Palette[0], Palette[1]);
+		Palette[3] = MixColors<1, 2, 3>(Palette[0], Palette[1]);
+	}
+
+	else
+	{
+		Palette[2] = MixColors<1, 1, 2>(Palette[0], Palette[1]);
+		Palette[3] = 0;
+	}
+
+	Kernels.ExpandIndices(ReadU32(Block + 4), Palette, Out);
+}
+
+/* BC2 stores 4 bit alpha per pixel */
+static void DecodeExplicitAlpha(const unsigned char* Block, unsigned char Alpha[16])
+{
+	for (int i = 0; i < 16; i++)
+	{
+		unsigned char Nibble = (Block[i / 2] >> (4 * (i & 1))) & 0xF;
+		Alpha[i] = (unsigned char)(Nibble * 17);
+	}
+}
+
+/* BC3 interpolates 8 alpha values between two endpoints and stores a 3 bit index per pixel */
+static void DecodeInterpolatedAlpha(const unsigned char* Block, unsigned char Alpha[16])
+{
+	unsigned int Palette[8];
+	Palette[0] = Block[0];
+	Palette[1] = Block[1];
+
+	if (Palette[0] > Palette[1])
+	{
+		for (int i = 2; i < 8; i++)
+		{
+			Palette[i] = ((8 - i) * Palette[0] + (i - 1) * Palette[1]) / 7;
+		}
+	}
+
+	else
+	{
+		for (int i = 2; i < 6; i++)
+		{
+			Palette[i] = ((6 - i) * Palette[0] + (i - 1) * Palette[1]) / 5;
+		}
+
+		Palette[6] = 0;
+		Palette[7] = 255;
+	}
+
+	uint64_t Indices = 0;
+	for (int i = 0; i < 6; i++)
+	{
+		Indices |= (uint64_t)Block[2 + i] << (8 * i);
+	}
+
+	for (int i = 0; i < 16; i++)
+	{
+		Alpha[i] = (unsigned char)Palette[(Indices >> (3 * i)) & 7];
+	}
+}
+
+static bool DecodeBlocks(const unsigned char* Data, size_t Size, DdsFormat Format, DecodedImage& Image, const DecoderKernels& Kernels)
+{
+	int BlocksWide = (Image.Width + 3) / 4;
+	int BlocksHigh = (Image.Height + 3) / 4;
+	size_t BlockSize = Format == FormatBc1 ? 8 : 16;
+	if (Size < (size_t)BlocksWide * BlocksHigh * BlockSize) return false;
+
+	uint32_t* Pixels = (uint32_t*)Image.Pixels.data();
+	uint32_t Decoded[16];
+	unsigned char Alpha[16];
+
+	for (int BlockY = 0; BlockY < BlocksHigh; BlockY++)
+	{
+		for (int BlockX = 0; BlockX < BlocksWide; BlockX++)
+		{
+			const unsigned char* Block = Data + ((size_t)BlockY * BlocksWide + BlockX) * BlockSize;
+
+			if (Format == FormatBc1)
+			{
+				DecodeColorBlock(Block, true, Kernels, Decoded);
+			}
+
+			else
+			{
+				DecodeColorBlock(Block + 8, false, Kernels, Decoded);
+				if (Format == FormatBc2) DecodeExplicitAlpha(Block, Alpha);
+				else DecodeInterpolatedAlpha(Block, Alpha);
+				Kernels.MergeAlpha(Alpha, Decoded);
+			}
+
+			uint32_t* Destination = Pixels + (size_t)BlockY * 4 * Image.Width + BlockX * 4;
+			int CopyWidth = Image.Width - BlockX * 4;
+			int CopyHeight = Image.Height - BlockY * 4;
+
+			if (CopyWidth >= 4 && CopyHeight >= 4)
+			{
+				for (int Row = 0; Row < 4; Row++)
+				{
+					memcpy(Destination + (size_t)Row * Image.Width, Decoded + Row * 4, 16);
+				}
+
+				continue;
+			}
+
+			/* Blocks on the right and bottom edge may reach past the image */
+			for (int Row = 0; Row < CopyHeight && Row < 4; Row++)
+			{
+				memcpy(Destination + (size_t)Row * Image.Width, Decoded + Row * 4, (CopyWidth < 4 ? CopyWidth : 4) * 4);
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool DecodeRgb32(const unsigned char* Data, size_t Size, Swizzle Mode, const ChannelShifts& Shifts, DecodedImage& Image, const DecoderKernels& Kernels)
+{
+	size_t RowSize = (size_t)Image.Width * 4;
+	if (Size < RowSize * Image.Height) return false;
+
+	/* Rows are converted one at a time, the source may not be 4 byte aligned */
+	std::vector<uint32_t> Row(Image.Width);
+
+	for (int y = 0; y < Image.Height; y++)
+	{
+		memcpy(Row.data(), Data + y * RowSize, RowSize);
+		Kernels.ConvertRow(Row.data(), (uint32_t*)(Image.Pixels.data() + y * RowSize), Image.Width, Mode, Shifts);
+	}
+
+	return true;
+}
+
+static DdsFormat FormatFromDxgi(uint32_t DxgiFormat, Swizzle& Mode)
+{
+	switch (DxgiFormat)
+	{
+	case 28: // DXGI_FORMAT_R8G8B8A8_UNORM
+	case 29: // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+		Mode = SwizzleCopy;
+		return FormatRgb32;
+
+	case 87: // DXGI_FORMAT_B8G8R8A8_UNORM
+	case 91: // DXGI_FORMAT_B8G8R8A8_UNORM_SRGB
+		Mode = SwizzleSwapRedBlue;
+		return FormatRgb32;
+
+	case 88: // DXGI_FORMAT_B8G8R8X8_UNORM
+	case 93: // DXGI_FORMAT_B8G8R8X8_UNORM_SRGB
+		Mode = SwizzleSwapRedBlueSetAlpha;
+		return FormatRgb32;
+
+	case 71: // DXGI_FORMAT_BC1_UNORM
+	case 72: // DXGI_FORMAT_BC1_UNORM_SRGB
+		return FormatBc1;
+
+	case 74: // DXGI_FORMAT_BC2_UNORM
+	case 75: // DXGI_FORMAT_BC2_UNORM_SRGB
+		return FormatBc2;
+
+	case 77: // DXGI_FORMAT_BC3_UNORM
+	case 78: // DXGI_FORMAT_BC3_UNORM_SRGB
+		return FormatBc3;
+
+	default:
+		return FormatUnsupported;
+	}
+}
+
+static bool DecodeDdsInto(const unsigned char* Data, size_t Size, DecodedImage& Image, DdsDecoder Decoder)
+{
+	if (Size < DdsHeaderSize || ReadU32(Data) != DdsMagic || ReadU32(Data + 4) != 124) return false;
+
+	uint32_t Height = ReadU32(Data + 12);
+	uint32_t Width = ReadU32(Data + 16);
+	uint32_t PixelFlags = ReadU32(Data + 80);
+	uint32_t FourCC = ReadU32(Data + 84);
+	uint32_t BitCount = ReadU32(Data + 88);
+	if (Width == 0 || Height == 0 || Width > 16384 || Height > 16384) return false;
+
+	size_t Offset = DdsHeaderSize;
+	DdsFormat Format = FormatUnsupported;
+	Swizzle Mode = SwizzleCopy;
+	ChannelShifts Shifts = { 0, 8, 16, 24 };
+
+	if ((PixelFlags & PixelFormatFourCC) != 0)
+	{
+		if (FourCC == MakeFourCC('D', 'X', '1', '0'))
+		{
+			if (Size < DdsHeaderSize + Dx10HeaderSize) return false;
+			Format = FormatFromDxgi(ReadU32(Data + DdsHeaderSize), Mode);
+			Offset += Dx10HeaderSize;
+		}
+
+		else if (FourCC == MakeFourCC('D', 'X', 'T', '1')) Format = FormatBc1;
+		else if (FourCC == MakeFourCC('D', 'X', 'T', '2') || FourCC == MakeFourCC('D', 'X', 'T', '3')) Format = FormatBc2;
+		else if (FourCC == MakeFourCC('D', 'X', 'T', '4') || FourCC == MakeFourCC('D', 'X', 'T', '5')) Format = FormatBc3;
+	}
+
+	else if ((PixelFlags & PixelFormatRgb) != 0 && BitCount == 32)
+	{
+		bool bHasAlpha = (PixelFlags & PixelFormatAlphaPixels) != 0;
+		Shifts.Red = MaskShift(ReadU32(Data + 92));
+		Shifts.Green = MaskShift(ReadU32(Data + 96));
+		Shifts.Blue = MaskShift(ReadU32(Data + 100));
+		Shifts.Alpha = bHasAlpha ? MaskShift(ReadU32(Data + 104)) : -1;
+		if (Shifts.Red < 0 || Shifts.Green < 0 || Shifts.Blue < 0 || (bHasAlpha && Shifts.Alpha < 0)) return false;
+
+		Format = FormatRgb32;
+		bool bAlphaOnTop = !bHasAlpha || Shifts.Alpha == 24;
+		if (Shifts.Red == 0 && Shifts.Green == 8 && Shifts.Blue == 16 && bAlphaOnTop) Mode = bHasAlpha ? SwizzleCopy : SwizzleSetAlpha;
+		else if (Shifts.Red == 16 && Shifts.Green == 8 && Shifts.Blue == 0 && bAlphaOnTop) Mode = bHasAlpha ? SwizzleSwapRedBlue : SwizzleSwapRedBlueSetAlpha;
+		else Mode = SwizzleGeneric;
+	}
+
+	if (Format == FormatUnsupported) return false;
+
+	/* Every pixel is written below, so a buffer of the right size is reused as is */
+	Image.Width = (int)Width;
+	Image.Height = (int)Height;
+	Image.Pixels.resize((size_t)Width * Height * 4);
+
+	DecoderKernels Kernels = GetKernels(Decoder);
+	if (Format == FormatRgb32) return DecodeRgb32(Data + Offset, Size - Offset, Mode, Shifts, Image, Kernels);
+	return DecodeBlocks(Data + Offset, Size - Offset, Format, Image, Kernels);
+}
+
+bool DecodeDds(const unsigned char* Data, size_t Size, DecodedImage& Image, DdsDecoder Decoder)
+{
+	if (DecodeDdsInto(Data, Size, Image, Decoder)) return true;
+
+	Image = DecodedImage();
+	return false;
+}
+
+bool DecodeDds(const unsigned char* Data, size_t Size, DecodedImage& Image)
+{
+	return DecodeDds(Data, Size, Image, GetDdsDecoder());
+}
+
+bool LoadDdsFile(const std::string& Path, DecodedImage& Image)
+{
+	const unsigned char* Packed;
+	size_t PackedSize;
+	if (AssetPack::Find(Path.c_str(), Packed, PackedSize)) return DecodeDds(Packed, PackedSize, Image);
+
+	std::ifstream File(Path, std::ios::binary | std::ios::ate);
+	if (!File) return false;
+
+	std::streamoff Size = File.tellg();
+	if (Size <= 0) return false;
+
+	std::vector<unsigned char> Data((size_t)Size);
+	File.seekg(0);
+	if (!File.read((char*)Data.data(), Size)) return false;
+
+	return DecodeDds(Data.data(), Data.size(), Image);
+}
+
+DdsDecoder GetDdsDecoder()
+{
+#ifdef DDSLOADER_X86
+	static const DdsDecoder Decoder = CpuSupportsAvx2() ? DdsDecoderAvx2 : DdsDecoderSse2;
+#else
+	static const DdsDecoder Decoder = DdsDecoderScalar;
+#endif
+	return Decoder;
+}
+
+const char* GetDdsDecoderName(DdsDecoder Decoder)
+{
+	if (Decoder == DdsDecoderAvx2) return "AVX2";
+	if (Decoder == DdsDecoderSse2) return "SSE2";
+	return "Scalar";
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/* Tightly packed 32 bit RGBA pixels */
+struct DecodedImage
+{
+    int Width;
+    int Height;
+    std::vector<unsigned char> Pixels;
+};
+
+/* Instruction sets the DDS decoder can use for channel swizzles and block decompression */
+enum DdsDecoder
+{
+    DdsDecoderScalar,
+    DdsDecoderSse2,
+
+    /* Must only be used when the CPU and OS support AVX2 */
+    DdsDecoderAvx2
+};
+
+/* Decodes the top mip level of the first surface of a DDS file in memory into RGBA.
+   Supports uncompressed 32 bit RGB files with byte aligned channel masks, with or without alpha, and BC1, BC2 and BC3,
+   both as legacy FourCC and as DX10 header. Channels without alpha decode to opaque. Returns false and empties Image for anything else. */
+bool DecodeDds(const unsigned char* Data, size_t Size, DecodedImage& Image, DdsDecoder Decoder);
+
+/* Decodes with the fastest decoder supported by the CPU */
+bool DecodeDds(const unsigned char* Data, size_t Size, DecodedImage& Image);
+
+/* Reads and decodes a DDS file. Returns false if the file can not be read or decoded. */
+bool LoadDdsFile(const std::string& Path, DecodedImage& Image);
+
+/* Returns the fastest decoder supported by the CPU, detected once on the first call */
+DdsDecoder GetDdsDecoder();
+
+/* Name of a decoder for logging */
+const char* GetDdsDecoderName(DdsDecoder Decoder);
@@ -1,86 +1,157 @@
 #include "GameMode.h"
+#include "AssetPack.h"
 #include "SDL.h"
-#include <codecvt>
 #include "SDL_mixer.h"
-#include "DirectXTex.h"
 #include "SDL_ttf.h"
-#include <sstream>
+#include <algorithm>
 #include <string>
 #include <stdlib.h>
 
-#define _SILENCE_CXX17_CODECVT_HEADER_DEPRECATION_WARNING
-#pragma warning(push)
-#pragma warning(disable: 26812) // Prefer enum class over enum  
-#include "tinyxml2.h"
-#pragma warning(pop)
+const float AspectRatio = WorldSize.x / WorldSize.y;
+const float HeadlessTimeStep = 1.0f / 60.0f;
 
-using namespace tinyxml2;
+/* Assets shared by all levels */
+const char* WallSoundPath = "Assets/Sounds/HitWall.wav";
+const char* PaddleSoundPath = "Assets/Sounds/HitPaddle.wav";
+const char* PaddleTexturePath = "Assets/Textures/Paddle/Paddle.dds";
+const char* CubeTexturePath = "Assets/Textures/Cube/Cube.dds";
+const char* BorderTexturePath = "Assets/Textures/Border/Border.dds";
 
-/* Operators for easy vector addition, vector substraction etc. */
-Vector2D operator+(Vector2D a, Vector2D b)
+/* Opens a font from the mounted asset pack if it holds it, from its file otherwise. The pack stays mapped while the font is open. */
+static TTF_Font* OpenFont(const char* Path, int Size)
 {
-	return { a.x + b.x, a.y + b.y };
+	const unsigned char* Data;
+	size_t DataSize;
+	if (AssetPack::Find(Path, Data, DataSize)) return TTF_OpenFontRW(SDL_RWFromConstMem(Data, (int)DataSize), 1, Size);
+	return TTF_OpenFont(Path, Size);
 }
 
-Vector2D operator-(Vector2D a, Vector2D b)
-{
-	return { a.x - b.x, a.y - b.y };
-}
 
-Vector2D operator*(Vector2D vector, float scalar)
+GameMode::GameMode(int WindowWidth, int WindowHeight, bool bHeadless, int HeadlessTicks, int TickRate, int MaxCatchUpSteps) :
+	WindowWidth(WindowWidth),
+	WindowHeight(WindowHeight),
+	bHeadless(bHeadless),
+	HeadlessTicks(HeadlessTicks),
+	TickRate(std::max(TickRate, 1)),
+	MaxCatchUpSteps(std::max(MaxCatchUpSteps, 1)),
+	FixedTimeStep(1.0f / std::max(TickRate, 1)),
+	Accumulator(0),
+	GameWindow(nullptr),
+	GameRenderer(nullptr),
+	FontArial_16(nullptr),
+	FontArial_24(nullptr),
+	HudValues{ -1, -1, -1, -1 },
+	BackgroundTexture(-1),
+	StaticLayer(nullptr),
+	bStaticLayerDirty(true),
+	BrickLayer(nullptr),
+	bBrickLayerDirty(true),
+	PaddleTexture(-1),
+	CubeTexture(-1),
+	BorderTexture(-1),
+	WallSound(-1),
+	PaddleSound(-1),
+	UploadedLevel(nullptr),
+	MouseX(0),
+	MouseY(0),
+	GameClock(bHeadless ? (Clock*)&SimulatedClock : &RealClock),
+	Time(0),
+	Seconds(0),
+	LastFrameTime(0),
+	GameStartTime(0),
+	StartupTime(0),
+	bFirstFramePresented(false),
+	PreviousPaddle{ 0, 0 },
+	PreviousCube{ 0, 0 },
+	RenderAlpha(1),
+	bSnapInterpolation(true),
+	TracePath("BreakoutTrace.json"),
+	bQuit(false)
 {
-	return { vector.x * scalar, vector.y * scalar };
+	Init();
+	Run();
 }
 
-float dot(Vector2D a, Vector2D b)
+void GameMode::Init()
 {
-	return a.x * b.x + a.y * b.y;
-}
+	StartupTime = RealClock.Now();
 
-float lengthSquared(Vector2D vector)
-{
-	return dot(vector, vector);
-}
+	if (!bHeadless) InitBackends();
 
-float length(Vector2D vector)
-{
-	return (float)sqrt(lengthSquared(vector));
+	std::cout << "Brick sweep kernel: " << GetSweepBricksName(Simulation.GetSweepKernel()) << std::endl;
+
+	/* Without a Renderer or audio device the caches act as null backends and return invalid handles */
+	Textures.Init(GameRenderer);
+	GlyphsArial_16.Init(GameRenderer, FontArial_16);
+	GlyphsArial_24.Init(GameRenderer, FontArial_24);
+	Sprites.Init(GameRenderer);
+	Sounds.Init(!bHeadless);
+
+	Levels.push_back("Assets/Levels/Level1.xml");
+	Levels.push_back("Assets/Levels/Level2.xml");
+	Levels.push_back("Assets/Levels/Level3.xml");
+	Simulation.Init(Levels);
+
+	/* Headless games have nothing to upload to and parse their levels on demand */
+	if (!bHeadless) Preload();
+
+	/* Load sounds shared by all levels */
+	WallSound = Sounds.Load(WallSoundPath);
+	PaddleSound = Sounds.Load(PaddleSoundPath);
+
+	/* Load textures shared by all levels */
+	PaddleTexture = Sprites.Add(PaddleTexturePath);
+	CubeTexture = Sprites.Add(CubeTexturePath);
+	BorderTexture = Sprites.Add(BorderTexturePath);
+	Sprites.Build();
+
+	Streamer.Start(!bHeadless);
 }
 
-Vector2D normalize(Vector2D vector)
+void GameMode::Preload()
 {
-	float inverseLength = 1.0f / length(vector);
-	return { vector.x * inverseLength, vector.y * inverseLength };
-}
+	PROFILE_ZONE("Preload");
 
+	double Start = RealClock.Now();
+	PreloadedAssets Assets;
 
+	{
+		ThreadPool Pool;
+		PreloadAssets(Pool, Levels, { PaddleTexturePath, CubeTexturePath, BorderTexturePath }, { WallSoundPath, PaddleSoundPath }, Assets);
+	}
 
-const Vector2D PaddleSize = { 0.1f, 0.025f };
-const Vector2D CubeSize = { 0.015f, 0.02f };
-const Vector2D WorldSize = { 1.0f, 5.0f / 4.0f };
-const float PaddleY = 0.9f * WorldSize.y;
-const float Border = 0.05f;
-const float PaddleCornerWidth = PaddleSize.x * 0.1f;
-const float AspectRatio = WorldSize.x / WorldSize.y;
+	double Decoded = RealClock.Now();
 
+	/* Only the uploads are serialized, the Renderer and the mixer belong to this thread */
+	for (int i = 0; i < (int)Assets.Levels.size(); i++)
+	{
+		if (Assets.Levels[i]) Simulation.SetLevel(i, Assets.Levels[i]);
+	}
 
-GameMode::GameMode(int WindowWidth, int WindowHeight) :
-	WindowWidth(WindowWidth),
-	WindowHeight(WindowHeight),
-	Time(0),
-	bQuit(false),
-	ColumnCount(0),
-	ColumnSpacing(0),
-	RowCount(0),
-	RowSpacing(0),
-	Seconds(0),
-	MaxScore(0)
-{
-	Init();
-	Run();
+	for (size_t i = 0; i < Assets.BackgroundPaths.size(); i++)
+	{
+		if (Assets.BackgroundImages[i].Width > 0) Textures.Load(Assets.BackgroundPaths[i], std::move(Assets.BackgroundImages[i]));
+	}
+
+	for (size_t i = 0; i < Assets.SpritePaths.size(); i++)
+	{
+		if (Assets.SpriteImages[i].Width > 0) Sprites.Add(Assets.SpritePaths[i], std::move(Assets.SpriteImages[i]));
+	}
+
+	for (size_t i = 0; i < Assets.SoundPaths.size(); i++)
+	{
+		const std::vector<unsigned char>& File = Assets.SoundFiles[i];
+		if (File.empty()) Sounds.Load(Assets.SoundPaths[i]);
+		else Sounds.Load(Assets.SoundPaths[i], File.data(), File.size());
+	}
+
+	Sprites.Build();
+
+	std::cout << "Preloaded " << Assets.Levels.size() << " levels, " << Assets.BackgroundPaths.size() + Assets.SpritePaths.size() << " textures and "
+		<< Assets.SoundPaths.size() << " sounds in " << (RealClock.Now() - Start) * 1000 << " ms (" << (Decoded - Start) * 1000 << " ms decoding)" << std::endl;
 }
 
-void GameMode::Init()
+void GameMode::InitBackends()
 {
 	/* Initialize SDL. If Initialization fails log error.  */
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0)
@@ -99,10 +170,10 @@ void GameMode::Init()
 	{
 		std::cerr << "TTF Initialization failed: " << SDL_GetError() << std::endl;
 	}
-	
+
 	/* Open fonts */
-	FontArial_16 = TTF_OpenFont("Assets/Fonts/arial.ttf", 16);
-	FontArial_24 = TTF_OpenFont("Assets/Fonts/arial.ttf", 24);
+	FontArial_16 = OpenFont("Assets/Fonts/arial.ttf", 16);
+	FontArial_24 = OpenFont("Assets/Fonts/arial.ttf", 24);
 
 	/* Create Window. If Window creation fails log error. */
 	GameWindow = SDL_CreateWindow("Breakout", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WindowWidth, WindowHeight, SDL_WINDOW_SHOWN);
@@ -111,671 +182,674 @@ void GameMode::Init()
 		std::cerr << "Creating Window failed: " << SDL_GetError() << std::endl;
 	}
 
+	/* Scale textures linearly, they are uploaded once at their native size */
+	SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "1");
+
 	/* Create Renderer. If Renderer creation fails log error. */
 	GameRenderer = SDL_CreateRenderer(GameWindow, -1, SDL_RENDERER_PRESENTVSYNC);
 	if (GameRenderer == nullptr)
 	{
 		std::cerr << "Creating Renderer failed: " << SDL_GetError() << std::endl;
 	}
+}
 
-	Levels.push_back("Assets/Levels/Level1.xml");
-	Levels.push_back("Assets/Levels/Level2.xml");
-	Levels.push_back("Assets/Levels/Level3.xml");
+void GameMode::NextLevel()
+{
+	Simulation.NextLevel();
+	ProcessEvents();
 }
 
-void GameMode::SetBricks()
+void GameMode::ResetLevel()
 {
-	/* Removes all the bricks from BricksInGame vector. Reduces capacity of the vector to fit its size. */
-	BricksInGame.clear();
-	BricksInGame.shrink_to_fit();
+	Simulation.ResetLevel();
+}
 
-	MaxLevelScore = 0;
-	Vector2D BrickSize = { (1 - 2 * Border - (ColumnCount + 1) * 0.0011875f) / ColumnCount, WorldSize.y * 0.025f };
-	float TopOffset = BrickSize.y * 4;
+void GameMode::ResetGame()
+{
+	GameStartTime = GameClock->Now();
+	Simulation.ResetGame();
+	ProcessEvents();
+}
 
-	for (int i = 0; i < BricksLayout.size(); i++)
-	{
-		int ColumnCounter = 1;
+void GameMode::Update(float MouseX, float MouseY, float Time)
+{
+	PROFILE_ZONE("Update");
 
-		for (int j = 0; j < BricksLayout.at(i).size(); j++)
+	this->MouseX = MouseX;
+	this->MouseY = MouseY;
+
+	Simulation.Update(MouseX / WindowWidth, Time);
+	ProcessEvents();
+}
+
+void GameMode::ProcessEvents()
+{
+	for (const SimulationEvent& Event : Simulation.GetEvents())
+	{
+		switch (Event.Type)
 		{
-			/* Sets Bricks position */
-			BrickType Brick;
-			Brick.brickBox.min = Vector2D{ Border + j * BrickSize.x + ColumnCounter * 0.0011875f, Border + TopOffset + i * BrickSize.y + i * 0.0022875f };
-			Brick.brickBox.max = Brick.brickBox.min + BrickSize;
+		case EventHitWall:
+			Sounds.Play(WallSound);
+			break;
 
-			ColumnCounter++;
+		case EventHitPaddle:
+			Sounds.Play(PaddleSound);
+			break;
 
-			if (BricksLayout.at(i).at(j) == LevelBricks.at(0).Id.at(0))
-			{
-				Brick.Id = LevelBricks.at(0).Id;
-				Brick.Texture = LevelBricks.at(0).Texture;
-				Brick.HitPoints = LevelBricks.at(0).HitPoints;
-				Brick.HitSound = LevelBricks.at(0).HitSound;
-				Brick.BreakSound = LevelBricks.at(0).BreakSound;
-				Brick.BreakScore = LevelBricks.at(0).BreakScore;
-			}
+		case EventHitBrick:
+			Sounds.Play(BrickHitSounds.at(Event.BrickType));
+			break;
 
-			if (BricksLayout.at(i).at(j) == LevelBricks.at(1).Id.at(0))
-			{
-				Brick.Id = LevelBricks.at(1).Id;
-				Brick.Texture = LevelBricks.at(1).Texture;
-				Brick.HitPoints = LevelBricks.at(1).HitPoints;
-				Brick.HitSound = LevelBricks.at(1).HitSound;
-				Brick.BreakSound = LevelBricks.at(1).BreakSound;
-				Brick.BreakScore = LevelBricks.at(1).BreakScore;
+		case EventBreakBrick:
+			Sounds.Play(BrickBreakSounds.at(Event.BrickType));
 
-			}
+			/* A hit leaves the look of a brick unchanged, only removed bricks need to be redrawn */
+			DirtyBricks.push_back(Event);
+			break;
 
-			if (BricksLayout.at(i).at(j) == LevelBricks.at(2).Id.at(0))
-			{
-				Brick.Id = LevelBricks.at(2).Id;
-				Brick.Texture = LevelBricks.at(2).Texture;
-				Brick.HitPoints = LevelBricks.at(2).HitPoints;
-				Brick.HitSound = LevelBricks.at(2).HitSound;
-				Brick.BreakSound = LevelBricks.at(2).BreakSound;
-				Brick.BreakScore = LevelBricks.at(2).BreakScore;
-			}
+		case EventGameOver:
+			/* The final state stays on screen, ResetGame restarts the clock and the bricks when the player starts again */
+			break;
 
-			if (BricksLayout.at(i).at(j) == LevelBricks.at(3).Id.at(0))
+		case EventLevelStarted:
+			/* The next level loads in the background while this one is played */
+			if (Simulation.GetLevelIndex() + 1 < Simulation.GetLevelCount() && !Simulation.HasLevel(Simulation.GetLevelIndex() + 1))
 			{
-				Brick.Id = LevelBricks.at(3).Id;
-				Brick.Texture = LevelBricks.at(3).Texture;
-				Brick.HitPoints = INT_MAX;
-				Brick.HitSound = LevelBricks.at(3).HitSound;
-				Brick.BreakSound = "";
-				Brick.BreakScore = 0;
-
+				Streamer.Request(Simulation.GetLevelIndex() + 1, Levels.at(Simulation.GetLevelIndex() + 1));
 			}
 
-			if (BricksLayout.at(i).at(j) == '_') continue;
+			/* Refills the bricks like a lost life */
+			bSnapInterpolation = true;
+			bBrickLayerDirty = true;
+			break;
+
+		case EventLostLife:
+			bSnapInterpolation = true;
+			bBrickLayerDirty = true;
+			break;
 
-			MaxScore += Brick.BreakScore;
-			MaxLevelScore += Brick.BreakScore;
-			BricksInGame.push_back(Brick);
+		default:
+			break;
 		}
 	}
-}
 
-void GameMode::NextLevel()
-{
-	bShouldPause = true;
-	CurrentScore = 0;
-	UploadLevel(Levels.at(LevelCounter));
-	ResetLevel();
-}
+	Simulation.ClearEvents();
 
-void GameMode::ResetLevel()
-{
-	/* Resets positions of all Game objects */
-	Paddle = { 0.5f, PaddleY };
-	Cube = { 0.5f, PaddleY - PaddleSize.y };
-	SetBricks();
-	if (!bShouldPause) CubeDirection = normalize({ 0, -1 });
+	/* Level assets are loaded after the sounds of the finished level were played */
+	if (Simulation.GetLevel() != UploadedLevel) UploadLevel(*Simulation.GetLevel());
 }
 
-void GameMode::ResetGame()
+void GameMode::AdoptStreamedLevel()
 {
-	TimeForTime = SDL_GetTicks();
-	BeforeTimeForTime = SDL_GetTicks();
-	LifeCount = 4;
-	LevelCounter = 0;
-	Score = 0;
-	CurrentScore = 0;
-	MaxScore = 0;
-	NextLevel();
-}
+	std::unique_ptr<PreparedLevel> Prepared = Streamer.TakeReady();
+	if (!Prepared) return;
 
-void GameMode::Update(float MouseX, float MouseY, float Time)
-{
-	this->MouseX = MouseX;
-	this->MouseY = MouseY;
+	PROFILE_ZONE("AdoptStreamedLevel");
+
+	/* The level may have been loaded synchronously already if it was reached before the worker finished */
+	if (!Simulation.HasLevel(Prepared->Index)) Simulation.SetLevel(Prepared->Index, Prepared->Level);
+	if (bHeadless) return;
 
-	Paddle.x = MouseX / WindowWidth;
-	Paddle.y = PaddleY;
+	const LevelData& Level = *Prepared->Level;
+	Textures.Load(Level.BackgroundPath.GetPath(), std::move(Prepared->Background));
 
-	/* Paddle and Wall collision */
-	if (Paddle.x - PaddleSize.x * 0.5f < Border)
+	for (size_t i = 0; i < Level.BrickTypes.size(); i++)
 	{
-		Paddle.x = PaddleSize.x * 0.5f + Border;
+		Sprites.Add(Level.BrickTypes[i].Texture.GetPath(), std::move(Prepared->BrickImages[i]));
+		Sounds.Load(Level.BrickTypes[i].HitSound);
+		Sounds.Load(Level.BrickTypes[i].BreakSound);
 	}
 
-	else if (Paddle.x + PaddleSize.x * 0.5f > 1 - Border)
+	Sprites.Build();
+}
+
+void GameMode::Run()
+{
+	if (bHeadless)
 	{
-		Paddle.x = 1 - Border - PaddleSize.x * 0.5f;
+		RunHeadless();
+		return;
 	}
 
-	float TimeAllowed = Time;
-	int HitIndex = -1;
-	bool bCollisionDetected = false;
-	Vector2D ChangeDirection = CubeDirection;
-	std::string WallSoundPath = "Assets/Sounds/HitWall.wav";
-	std::string PaddleSoundPath = "Assets/Sounds/HitPaddle.wav";
+	LastFrameTime = GameClock->Now();
+	GameStartTime = LastFrameTime;
 
-	Box2D CubeBox = { Cube - CubeSize * 0.5f, Cube + CubeSize * 0.5f };
-	Box2D PaddleBox = { Paddle - PaddleSize * 0.5f, Paddle + PaddleSize * 0.5f };
+	ResetGame();
 
+	while (!bQuit)
 	{
-		/* Cube and Wall collision */
-		if (CubeDirection.x > 0)
-		{
-			float TimeOfHit = (1 - Border - CubeBox.max.x) / CubeDirection.x;
-			if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
-			{
-				TimeAllowed = TimeOfHit;
-				ChangeDirection = { -CubeDirection.x, CubeDirection.y };
-				bCollisionDetected = true;
-				HitIndex = -1;
-				Mix_PlayChannel(-1, Mix_LoadWAV(WallSoundPath.c_str()), 0);
-			}
-		}
-
-		else if (CubeDirection.x < 0)
-		{
-			float TimeOfHit = (Border - CubeBox.min.x) / CubeDirection.x;
-			if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
-			{
-				TimeAllowed = TimeOfHit;
-				ChangeDirection = { -CubeDirection.x, CubeDirection.y };
-				bCollisionDetected = true;
-				HitIndex = -1;
-				Mix_PlayChannel(-1, Mix_LoadWAV(WallSoundPath.c_str()), 0);
-			}
-		}
+		SDL_Event Event;
+		PROFILE_ZONE("Frame");
 
-		if (CubeDirection.y < 0)
-		{
-			float TimeOfHit = (Border - CubeBox.min.y) / CubeDirection.y;
-			if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
-			{
-				TimeAllowed = TimeOfHit;
-				ChangeDirection = { CubeDirection.x, -CubeDirection.y };
-				bCollisionDetected = true;
-				HitIndex = -1;
-				Mix_PlayChannel(-1, Mix_LoadWAV(WallSoundPath.c_str()), 0);
-			}
+		if (Simulation.IsGameOver()) {
+			std::cout << "Game END!" << std::endl;
+			RenderGameOver();
 		}
-
-		if (CubeDirection.y > 0)
+			
+		/* Handle events */
 		{
-			float TimeOfHit = (PaddleBox.min.y - CubeBox.max.y) / CubeDirection.y;
+			PROFILE_ZONE("EventPump");
 
-			if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
+			while (SDL_PollEvent(&Event) || Simulation.IsGameOver())
 			{
-				float NewCube = Cube.x + CubeDirection.x * TimeOfHit;
-				float NewCubeMin = CubeBox.min.x + CubeDirection.x * TimeOfHit;
-				float NewCubeMax = CubeBox.max.x + CubeDirection.x * TimeOfHit;
-
-				/* Cube and Paddle collision */
-				if ((NewCubeMax >= PaddleBox.min.x) && (PaddleBox.max.x >= NewCubeMin))
+				if (Event.type == SDL_QUIT)
 				{
-					Mix_PlayChannel(-1, Mix_LoadWAV(PaddleSoundPath.c_str()), 0);
-					if (NewCubeMin < PaddleBox.min.x + PaddleCornerWidth)
-					{
-						ChangeDirection = normalize({ -1,-1 });
-					}
-
-					else if (NewCubeMax > PaddleBox.max.x - PaddleCornerWidth)
-					{
-						ChangeDirection = normalize({ 1,-1 });
-					}
-
-					else if (NewCube <= Paddle.x)
-					{
-						ChangeDirection = normalize({ 0,-1 });
-					}
-
-					else
-					{
-						ChangeDirection = normalize({ 1,-1 });
-					}
-
-					TimeAllowed = TimeOfHit;
-					bCollisionDetected = true;
-					HitIndex = -1;
-
+					bQuit = true;
+					break;
 				}
-			}
-		}
-
-		
-		/* Cube and Bricks collision */
-		for (int i = 0; i < BricksInGame.size(); i++)
-		{
-			auto Brick = &BricksInGame[i];
 
-			if (CubeDirection.x > 0)
-			{
-				float TimeOfHit = (Brick->brickBox.min.x - CubeBox.max.x) / CubeDirection.x;
-				if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
+				if (Event.type == SDL_KEYDOWN && Event.key.keysym.sym == SDLK_F9 && !Simulation.IsGameOver())
 				{
-					float NewCubeMin = CubeBox.min.y + CubeDirection.y * TimeOfHit;
-					float NewCubeMax = CubeBox.max.y + CubeDirection.y * TimeOfHit;
-
-					if ((NewCubeMax >= Brick->brickBox.min.y) && (Brick->brickBox.max.y >= NewCubeMin))
-					{
-						TimeAllowed = TimeOfHit;
-						ChangeDirection = { -CubeDirection.x, CubeDirection.y };
-						bCollisionDetected = true;
-						HitIndex = i;
-					}
+					ToggleProfiling();
 				}
-			}
 
-			else if (CubeDirection.x < 0)
-			{
-				float TimeOfHit = (Brick->brickBox.max.x - CubeBox.min.x) / CubeDirection.x;
-				if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
+				/* Render target contents are lost when the device is reset, e.g. on a display mode change */
+				if (Event.type == SDL_RENDER_TARGETS_RESET)
 				{
-					float NewCubeMin = CubeBox.min.y + CubeDirection.y * TimeOfHit;
-					float NewCubeMax = CubeBox.max.y + CubeDirection.y * TimeOfHit;
-
-					if ((NewCubeMax >= Brick->brickBox.min.y) && (Brick->brickBox.max.y >= NewCubeMin))
-					{
-						TimeAllowed = TimeOfHit;
-						ChangeDirection = { -CubeDirection.x, CubeDirection.y };
-						bCollisionDetected = true;
-						HitIndex = i;
-					}
+					bStaticLayerDirty = true;
+					bBrickLayerDirty = true;
 				}
-			}
 
-			if (CubeDirection.y > 0)
-			{
-				float TimeOfHit = (Brick->brickBox.min.y - CubeBox.max.y) / CubeDirection.y;
+				if (Event.type == SDL_WINDOWEVENT && Event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+				{
+					OnWindowResized(Event.window.data1, Event.window.data2);
+				}
 
-				if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
+				if (Event.type == SDL_MOUSEMOTION)
 				{
-					float NewCubeMin = CubeBox.min.x + CubeDirection.x * TimeOfHit;
-					float NewCubeMax = CubeBox.max.x + CubeDirection.x * TimeOfHit;
+					SDL_ShowCursor(SDL_DISABLE);
+					MouseX = (float)Event.motion.x;
+					MouseY = (float)Event.motion.y;
+				}
 
-					if ((NewCubeMax >= Brick->brickBox.min.x) && (Brick->brickBox.max.x >= NewCubeMin))
+				if (Simulation.IsPaused())
+				{
+					if (Event.type == SDL_KEYDOWN)
 					{
-						TimeAllowed = TimeOfHit;
-						ChangeDirection = { CubeDirection.x, -CubeDirection.y };
-						bCollisionDetected = true;
-						HitIndex = i;
+						if (Event.key.keysym.sym == SDLK_SPACE)
+						{
+							std::cout << "SPACE pressed - Release cube!" << std::endl;
+							Simulation.Release();
+							break;
+						}
 					}
 				}
 
-			}
-
-			else if (CubeDirection.y < 0)
-			{
-				float TimeOfHit = (Brick->brickBox.max.y - CubeBox.min.y) / CubeDirection.y;
-				if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
+				if (Event.type == SDL_KEYDOWN && Event.key.keysym.sym == SDLK_RETURN)
 				{
-					float NewCubeMin = CubeBox.min.x + CubeDirection.x * TimeOfHit;
-					float NewCubeMax = CubeBox.max.x + CubeDirection.x * TimeOfHit;
-
-					if ((NewCubeMax >= Brick->brickBox.min.x) && (Brick->brickBox.max.x >= NewCubeMin))
-					{
-						TimeAllowed = TimeOfHit;
-						ChangeDirection = { CubeDirection.x, -CubeDirection.y };
-						bCollisionDetected = true;
-						HitIndex = i;
+					if (Simulation.IsGameOver()) {
+						std::cout << "ENTER pressed - End game!" << std::endl;
+						Seconds = 0;
+						Simulation.ClearGameOver();
+						ResetGame();
+						break;
 					}
 				}
 			}
 		}
 
-		// Slow down cube speed *0.6f
-		Cube = Cube + CubeDirection * TimeAllowed * 0.6f;
-
-		if (bCollisionDetected)
-		{
-			CubeDirection = ChangeDirection;
-
-			if (HitIndex != -1)
-			{
-				auto Brick = &BricksInGame[HitIndex];
-
-				if (Brick->HitPoints > 0)
-				{
-					Brick->HitPoints--;
-					Mix_PlayChannel(-1, Mix_LoadWAV((Brick->HitSound).c_str()), 0);
-				}
+		AdoptStreamedLevel();
 
-				if (Brick->HitPoints == 0)
-				{
-					Mix_PlayChannel(-1, Mix_LoadWAV((Brick->BreakSound).c_str()), 0);
-					CurrentScore += Brick->BreakScore;
-					Score += Brick->BreakScore;
-					BricksInGame[HitIndex] = BricksInGame.back();
-					BricksInGame.pop_back();
-
-					
-					std::cout << "HIT!" << std::endl;
-					std::cout << "CurrentScore: " << CurrentScore << std::endl;
-					std::cout << "MaxLevelScore: " << MaxLevelScore << std::endl;
-					std::cout << "LevelCounter: " << LevelCounter << std::endl;
-					std::cout << "Score: " << Score << std::endl;
-					std::cout << "MaxScore: " << MaxScore << std::endl;
-
-					if (CurrentScore == MaxLevelScore && LevelCounter < Levels.size() - 1)
-					{
-						bShouldPause = true;
-						if (LevelCounter <= 1) LevelCounter++;
-						NextLevel();
-					}
+		double Now = GameClock->Now();
+		float timeStep = (float)(Now - LastFrameTime);
+		Seconds = (float)(Now - GameStartTime);
+		LastFrameTime = Now;
 
-					else if (CurrentScore == MaxLevelScore && LevelCounter == Levels.size() - 1)
-					{
-						bGameOver = true;
-					}
+		StepFixed(timeStep);
+		if (!Simulation.IsGameOver()) Render();
+		Sounds.Flush();
 
-				}
-			}
+		{
+			PROFILE_ZONE("Present");
+			SDL_RenderPresent(GameRenderer);
+			SDL_RenderClear(GameRenderer);
 		}
 
-		if (CubeBox.min.y >= WorldSize.y)
+		if (!bFirstFramePresented)
 		{
-			if (LifeCount == 0)
-			{
-				LevelCounter = 0;
-				bGameOver = true;
-				bShouldPause = true;
-				ResetGame();
-			}
-
-			else if (LifeCount > 0)
-			{
-				Score = Score - CurrentScore;
-				MaxScore = Score;
-				CurrentScore = 0;
-				LifeCount--;
-				bShouldPause = true;
-				ResetLevel();
-			}
+			bFirstFramePresented = true;
+			std::cout << "Time to first frame: " << (RealClock.Now() - StartupTime) * 1000 << " ms" << std::endl;
 		}
-
 	}
 
+	if (StaticLayer != nullptr) SDL_DestroyTexture(StaticLayer);
+	if (BrickLayer != nullptr) SDL_DestroyTexture(BrickLayer);
+	Textures.Clear();
+	Sprites.Clear();
+	GlyphsArial_16.Clear();
+	GlyphsArial_24.Clear();
+	Sounds.Clear();
+	Mix_CloseAudio();
+	SDL_DestroyRenderer(GameRenderer);
+	SDL_DestroyWindow(GameWindow);
+	TTF_Quit();
+	SDL_Quit();
 }
 
-void GameMode::Run()
+void GameMode::ToggleProfiling()
 {
-	BeforeTime = SDL_GetTicks();
-	BeforeTimeForTime = SDL_GetTicks();
+	if (!Profiler::IsEnabled())
+	{
+		Profiler::Reset();
+		Profiler::SetEnabled(true);
+		std::cout << "Profiler capture started, press F9 again to write " << TracePath << std::endl;
+		return;
+	}
 
-	bShouldPause = true;
-	bStartGame = true;
-	ResetGame();
+	Profiler::SetEnabled(false);
 
-	while (!bQuit)
+	if (Profiler::WriteChromeTrace(TracePath))
 	{
-		SDL_Event Event;
+		std::cout << "Profiler trace written to " << TracePath << std::endl;
+	}
 
-		if (bGameOver) {
-			std::cout << "Game END!" << std::endl;
-			RenderGameOver();
-		}
-			
-		/* Handle events */
-		while (SDL_PollEvent(&Event) || bGameOver)
-		{
-			if (Event.type == SDL_QUIT)
-			{
-				bQuit = true;
-				break;
-			}
+	else
+	{
+		std::cerr << "Writing profiler trace failed: " << TracePath << std::endl;
+	}
+}
 
-			if (Event.type == SDL_MOUSEMOTION)
-			{
-				SDL_ShowCursor(SDL_DISABLE);
-				MouseX = (float)Event.motion.x;
-				MouseY = (float)Event.motion.y;
-			}
+void GameMode::StepFixed(float FrameTime)
+{
+	/* While the cube waits for SPACE or the game is over no time is banked */
+	if (Simulation.IsPaused() || Simulation.IsGameOver())
+	{
+		Accumulator = 0;
+		bSnapInterpolation = true;
+	}
 
-			if (bShouldPause)
-			{
-				if (Event.type == SDL_KEYDOWN)
-				{
-					if (Event.key.keysym.sym == SDLK_SPACE)
-					{
-						std::cout << "SPACE pressed - Release cube!" << std::endl;
-						bShouldPause = false;
-						if (bStartGame) CubeDirection = normalize({ 0, -1 });
-						break;
-					}
-				}
-			}
+	else
+	{
+		Accumulator += FrameTime;
+	}
 
-			if (Event.type == SDL_KEYDOWN && Event.key.keysym.sym == SDLK_RETURN)
-			{
-				if (bGameOver) {
-					std::cout << "ENTER pressed - End game!" << std::endl;
-					Seconds = 0;
-					bGameOver = false;
-					ResetGame();
-					break;
-				}
-			}
-		}
+	int Steps = 0;
 
-		unsigned int time = SDL_GetTicks();
-		TimeForTime = SDL_GetTicks();
-		float timeStep = (float)(time - BeforeTime) / 1000.0f;
-		Seconds = (TimeForTime - BeforeTimeForTime) / 1000.0f;
-		BeforeTime = time;
+	while (Accumulator >= FixedTimeStep && Steps < MaxCatchUpSteps && !Simulation.IsPaused() && !Simulation.IsGameOver())
+	{
+		PreviousPaddle = Simulation.GetPaddle();
+		PreviousCube = Simulation.GetCube();
 
-		if (!bGameOver) Render();
-		if (!bShouldPause && !bGameOver) Update(MouseX, MouseY, timeStep);
+		Update(MouseX, MouseY, FixedTimeStep);
+		Accumulator -= FixedTimeStep;
+		Steps++;
+	}
 
-		SDL_RenderPresent(GameRenderer);
-		SDL_RenderClear(GameRenderer);
+	/* After a long hitch the remaining time is dropped instead of being simulated in later frames */
+	if (Steps == MaxCatchUpSteps && Accumulator >= FixedTimeStep) Accumulator = 0;
 
+	if (bSnapInterpolation)
+	{
+		PreviousPaddle = Simulation.GetPaddle();
+		PreviousCube = Simulation.GetCube();
+		bSnapInterpolation = false;
 	}
 
-	SDL_DestroyRenderer(GameRenderer);
-	SDL_DestroyWindow(GameWindow);
-	TTF_Quit();
-	SDL_Quit();
+	RenderAlpha = Accumulator / FixedTimeStep;
 }
 
-void GameMode::RenderGameInfo(float x, float y, std::string Text, int value, bool GameOver)
+void GameMode::RunHeadless()
 {
-	if (GameOver)
-	{
-		SDL_Color color = { 0, 0, 0, 255 };
-		SDL_Surface* GameOverSurface = TTF_RenderText_Solid(FontArial_24, Text.c_str(), color);
-		SDL_Texture* GameOverTexture = SDL_CreateTextureFromSurface(GameRenderer, GameOverSurface);
-		SDL_Rect GameOverRect = { (int)x, (int)y, 0,0 };
-		SDL_Rect dst = { int((WindowWidth - GameOverSurface->w) / 2), int((WindowHeight - Border*WindowWidth + GameOverSurface->h) / 2), 0, 0 };
-		SDL_QueryTexture(GameOverTexture, NULL, NULL, &dst.w, &dst.h);
-		SDL_RenderCopy(GameRenderer, GameOverTexture, NULL, &dst);
-		SDL_FreeSurface(GameOverSurface);
-		SDL_DestroyTexture(GameOverTexture);
+	ResetGame();
 
-		SDL_RenderPresent(GameRenderer);
-		SDL_RenderClear(GameRenderer);
-	}
+	unsigned int AutopilotSeed = 1;
+	int GamesPlayed = 0;
+	int GamesWon = 0;
+	long long TotalScore = 0;
 
-	else
+	double StartTime = RealClock.Now();
+
+	for (int Tick = 0; Tick < HeadlessTicks; Tick++)
 	{
-		SDL_Color color = { 0, 0, 0, 255 };
-		SDL_Surface* InfoSurface = TTF_RenderText_Solid(FontArial_16, (Text + std::to_string(value)).c_str(), color);
-		SDL_Texture* InfoTexture = SDL_CreateTextureFromSurface(GameRenderer, InfoSurface);
-		SDL_Rect InfoRect = { (int)x, (int)y, 0,0 };
-		SDL_QueryTexture(InfoTexture, NULL, NULL, &InfoRect.w, &InfoRect.h);
-		SDL_RenderCopy(GameRenderer, InfoTexture, NULL, &InfoRect);
+		AdoptStreamedLevel();
+
+		/* Release the cube right away instead of waiting for SPACE */
+		if (Simulation.IsPaused()) Simulation.Release();
+
+		/* The paddle follows the cube with an offset that changes every few bounces, so the cube does not get stuck in one path */
+		if (Tick % 97 == 0) AutopilotSeed = AutopilotSeed * 1103515245u + 12345u;
+		float Offset = PaddleSize.x * (((AutopilotSeed >> 16) & 0xFF) / 255.0f - 0.5f);
+		Update((Simulation.GetCube().x + Offset) * WindowWidth, 0, HeadlessTimeStep);
+		SimulatedClock.Advance(HeadlessTimeStep);
+
+		if (Simulation.IsGameOver())
+		{
+			GamesPlayed++;
+			if (Simulation.GetScore() == Simulation.GetMaxScore()) GamesWon++;
+			TotalScore += Simulation.GetScore();
 
-		SDL_FreeSurface(InfoSurface);
-		SDL_DestroyTexture(InfoTexture);
+			Simulation.ClearGameOver();
+			ResetGame();
+		}
 	}
+
+	double Seconds = RealClock.Now() - StartTime;
+
+	std::cout << "Headless ticks: " << HeadlessTicks << " (" << SimulatedClock.Now() << " s simulated)" << std::endl;
+	std::cout << "Ticks per second: " << (Seconds > 0 ? HeadlessTicks / Seconds : 0) << std::endl;
+	std::cout << "Games finished: " << GamesPlayed << " (won " << GamesWon << ", total score " << TotalScore << ")" << std::endl;
+	std::cout << "Current game: Level " << Simulation.GetLevelIndex() + 1 << ", Lives " << Simulation.GetLives() << ", Score " << Simulation.GetScore() << std::endl;
 }
 
-void GameMode::RenderRectFrame(float x, float y, float w, float h, SDL_Color Color)
+void GameMode::RenderHud()
 {
-	SDL_SetRenderDrawColor(GameRenderer, Color.r, Color.g, Color.b, Color.a);
-	SDL_Rect ColorRect = { (int)x, (int)y, (int)w, (int)h };
-	SDL_RenderDrawRect(GameRenderer, &ColorRect);
+	int Values[4] = { Simulation.GetLevelIndex() + 1, Simulation.GetLives(), Simulation.GetScore(), int(Seconds) };
+
+	if (!std::equal(Values, Values + 4, HudValues))
+	{
+		std::copy(Values, Values + 4, HudValues);
+
+		SDL_Color Color = { 0, 0, 0, 255 };
+		HudLayout.Clear();
+		GlyphsArial_16.Layout("Level: " + std::to_string(Values[0]), Border * WindowWidth, 4, Color, HudLayout);
+		GlyphsArial_16.Layout("Lives: " + std::to_string(Values[1]), Border * WindowWidth + WindowWidth * 0.175f, 4, Color, HudLayout);
+		GlyphsArial_16.Layout("Score: " + std::to_string(Values[2]), Border * WindowWidth + WindowWidth * 0.3f, 4, Color, HudLayout);
+		GlyphsArial_16.Layout("Time: " + std::to_string(Values[3]), Border * WindowWidth + WindowWidth * 0.425f, 4, Color, HudLayout);
+	}
+
+	GlyphsArial_16.Draw(GameRenderer, HudLayout);
 }
 
-void GameMode::RenderTexture(float x, float y, float w, float h, std::string Texture)
+void GameMode::OnWindowResized(int Width, int Height)
 {
-	DirectX::TexMetadata MetaData;
-	DirectX::ScratchImage ScratchImage;
-	std::string path = Texture;
-	std::wstring textures(path.begin(), path.end());
+	if (Width == WindowWidth && Height == WindowHeight) return;
 
-	if (DirectX::LoadFromDDSFile(textures.c_str(), DirectX::DDS_FLAGS_NONE, &MetaData, ScratchImage) != S_OK) {}
+	WindowWidth = Width;
+	WindowHeight = Height;
 
-	DirectX::ScratchImage ResizedImage;
-	if (DirectX::Resize(ScratchImage.GetImages(), ScratchImage.GetImageCount(), ScratchImage.GetMetadata(), size_t(w), size_t(h), DirectX::TEX_FILTER_DEFAULT, ResizedImage) != S_OK) {}
+	/* Everything sized in pixels is rebuilt lazily at the new size */
+	Textures.ClearScaled();
 
-	SDL_Surface* sdlSurface = SDL_CreateRGBSurfaceFrom(ResizedImage.GetPixels(), static_cast<int>(ResizedImage.GetMetadata().width), static_cast<int>(ResizedImage.GetMetadata().height), static_cast<int>(32), static_cast<int>(ResizedImage.GetMetadata().width * 4), 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
-	SDL_Texture* sdlTexture = SDL_CreateTextureFromSurface(GameRenderer, sdlSurface);
+	if (StaticLayer != nullptr) SDL_DestroyTexture(StaticLayer);
+	if (BrickLayer != nullptr) SDL_DestroyTexture(BrickLayer);
+	StaticLayer = nullptr;
+	BrickLayer = nullptr;
+	bStaticLayerDirty = true;
+	bBrickLayerDirty = true;
 
-	SDL_Rect dest = { (int)x, (int)y, (int)w, (int)h };
-	SDL_RenderCopy(GameRenderer, sdlTexture, NULL, &dest);
+	std::fill(HudValues, HudValues + 4, -1);
+	GameOverText.clear();
+}
 
-	SDL_FreeSurface(sdlSurface);
-	SDL_DestroyTexture(sdlTexture);
+void GameMode::RenderTexture(float x, float y, float w, float h, int Texture)
+{
+	PROFILE_ZONE("RenderTexture");
 
+	/* Drawn 1:1 from a copy resampled once per on-screen size instead of letting the GPU minify it every draw */
+	SDL_Rect dest = { (int)x, (int)y, (int)w, (int)h };
+	SDL_RenderCopy(GameRenderer, Textures.GetScaled(Texture, dest.w, dest.h), NULL, &dest);
 }
 
-void GameMode::RenderMinAndSizeTexture(Vector2D worldMin, Vector2D worldSize, std::string Texture, bool Frame)
+void GameMode::RenderMinAndSizeTexture(Vector2D worldMin, Vector2D worldSize, int Texture, bool Frame)
 {
 	Vector2D Min = { worldMin.x * WindowWidth, worldMin.y * WindowHeight * AspectRatio };
 	Vector2D Size = { worldSize.x * WindowWidth, worldSize.y * WindowHeight * AspectRatio };
-	if (!Frame) RenderTexture(Min.x, Min.y, Size.x, Size.y, Texture);
-	else RenderRectFrame(Min.x, Min.y, Size.x, Size.y, { 220,220,220,255 });
+	if (Texture < 0) return;
+	if (!Frame) Batch.AddSprite(Min.x, Min.y, Size.x, Size.y, Sprites.GetRect(Texture));
+	else Batch.AddFrame(Min.x, Min.y, Size.x, Size.y);
 
 }
 
-void GameMode::RenderMinAndMaxTexture(Vector2D worldMin, Vector2D worldMax, std::string Texture, bool Frame)
+void GameMode::RenderMinAndMaxTexture(Vector2D worldMin, Vector2D worldMax, int Texture, bool Frame)
 {
 	RenderMinAndSizeTexture(worldMin, worldMax - worldMin, Texture, Frame);
 }
 
 void GameMode::RenderBorder()
 {
-	std::string Path = "Assets/Textures/Border/Border.dds";
-	RenderMinAndMaxTexture({ 0,0 }, { Border, WorldSize.y }, Path, false);
-	RenderMinAndMaxTexture({ 1 - Border, 0 }, { 1, WorldSize.y }, Path, false);
-	RenderMinAndMaxTexture({ 0,0 }, { 1, Border }, Path, false);
+	RenderMinAndMaxTexture({ 0,0 }, { Border, WorldSize.y }, BorderTexture, false);
+	RenderMinAndMaxTexture({ 1 - Border, 0 }, { 1, WorldSize.y }, BorderTexture, false);
+	RenderMinAndMaxTexture({ 0,0 }, { 1, Border }, BorderTexture, false);
 }
 
-void GameMode::RenderGameOver()
+void GameMode::SubmitBatch()
 {
-	RenderBorder();
+	PROFILE_ZONE("Render Batch");
+	Batch.Submit(GameRenderer, Sprites.GetTexture(), { 220,220,220,255 });
+}
 
-	if (Score == MaxScore)
+void GameMode::RenderBrick(int Brick)
+{
+	const BrickStore& Bricks = Simulation.GetBricks();
+	Vector2D BrickMin = { Bricks.MinX[Brick], Bricks.MinY[Brick] };
+	Vector2D BrickMax = { Bricks.MaxX[Brick], Bricks.MaxY[Brick] };
+	int Texture = BrickTextures.at(Bricks.TypeIndex[Brick]);
+	RenderMinAndMaxTexture(BrickMin, BrickMax, Texture, false);
+	RenderMinAndMaxTexture(BrickMin, BrickMax, Texture, true);
+}
+
+SDL_Rect GameMode::GetBrickPixelRect(const Box2D& Box) const
+{
+	int MinX = (int)floorf(Box.min.x * WindowWidth);
+	int MinY = (int)floorf(Box.min.y * WindowHeight * AspectRatio);
+	int MaxX = (int)ceilf(Box.max.x * WindowWidth);
+	int MaxY = (int)ceilf(Box.max.y * WindowHeight * AspectRatio);
+	return { MinX, MinY, MaxX - MinX, MaxY - MinY };
+}
+
+void GameMode::BuildBrickLayer()
+{
+	PROFILE_ZONE("BuildBrickLayer");
+	bBrickLayerDirty = false;
+	DirtyBricks.clear();
+
+	if (!SDL_RenderTargetSupported(GameRenderer)) return;
+
+	if (BrickLayer == nullptr)
 	{
-		RenderGameInfo(WindowWidth / 2.f, WindowHeight / 2.f, "You WIN! Press Enter to start again!", 0, true);
+		BrickLayer = SDL_CreateTexture(GameRenderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, WindowWidth, WindowHeight);
+		if (BrickLayer == nullptr)
+		{
+			std::cerr << "Creating brick layer failed: " << SDL_GetError() << std::endl;
+			return;
+		}
+
+		SDL_SetTextureBlendMode(BrickLayer, SDL_BLENDMODE_BLEND);
 	}
-	else
+
+	const BrickStore& Bricks = Simulation.GetBricks();
+
+	SDL_SetRenderTarget(GameRenderer, BrickLayer);
+	SDL_SetRenderDrawColor(GameRenderer, 0, 0, 0, 0);
+	SDL_RenderClear(GameRenderer);
+
+	for (int i = 0; i < Bricks.Size(); i++)
 	{
-		RenderGameInfo(WindowWidth / 2.f, WindowHeight / 2.f, "GameOver! Press Enter to start again!", 0, true);
+		if (Bricks.IsAlive(i)) RenderBrick(i);
 	}
+
+	SubmitBatch();
+	SDL_SetRenderTarget(GameRenderer, NULL);
 }
 
-void GameMode::Render()
+void GameMode::UpdateBrickLayer()
 {
-	/* Background */
-	RenderTexture(Border * WindowWidth, Border * WindowHeight - 10, WindowWidth - 2 * Border * WindowWidth, WindowHeight - Border * WindowHeight + 10, BackgroundPath);
+	if (BrickLayer == nullptr || DirtyBricks.empty())
+	{
+		DirtyBricks.clear();
+		return;
+	}
+
+	PROFILE_ZONE("UpdateBrickLayer");
+	const BrickStore& Bricks = Simulation.GetBricks();
 
-	/* Left Corner */
-	RenderMinAndSizeTexture(Paddle - PaddleSize * 0.5f, Vector2D{ PaddleCornerWidth, PaddleSize.y }, "Assets/Textures/Paddle/Paddle.dds", false);
+	SDL_SetRenderTarget(GameRenderer, BrickLayer);
 
-	/* Right Corner */
-	RenderMinAndSizeTexture(Paddle + Vector2D{ PaddleSize.x * 0.5f - PaddleCornerWidth, PaddleSize.y * (-0.5f) }, Vector2D{ PaddleCornerWidth, PaddleSize.y }, "Assets/Textures/Paddle/Paddle.dds", false);
+	for (const SimulationEvent& Removed : DirtyBricks)
+	{
+		/* Clear the rectangle of the removed brick, then redraw the neighbours that may reach into it, clipped to it.
+		   The slot of a removed brick holds an empty box, so the rectangle comes from the box carried by the event. */
+		SDL_Rect Rect = GetBrickPixelRect(Removed.BrickBox);
+		SDL_RenderSetClipRect(GameRenderer, &Rect);
+		SDL_SetRenderDrawBlendMode(GameRenderer, SDL_BLENDMODE_NONE);
+		SDL_SetRenderDrawColor(GameRenderer, 0, 0, 0, 0);
+		SDL_RenderFillRect(GameRenderer, &Rect);
+
+		int Row = Removed.Brick / Bricks.Columns;
+		int Column = Removed.Brick % Bricks.Columns;
+
+		for (int r = std::max(Row - 1, 0); r <= std::min(Row + 1, Bricks.Rows - 1); r++)
+		{
+			for (int c = std::max(Column - 1, 0); c <= std::min(Column + 1, Bricks.Columns - 1); c++)
+			{
+				int Neighbour = r * Bricks.Columns + c;
+				if (Bricks.IsAlive(Neighbour)) RenderBrick(Neighbour);
+			}
+		}
 
-	/* Paddle*/
-	RenderMinAndSizeTexture(Paddle - PaddleSize * 0.5f + Vector2D{ PaddleCornerWidth, 0 }, PaddleSize - Vector2D{ PaddleCornerWidth * 2, 0 }, "Assets/Textures/Paddle/Paddle.dds", false);
+		SubmitBatch();
+	}
 
-	/* Cube*/
-	RenderMinAndSizeTexture(Cube - CubeSize * 0.5f, CubeSize, "Assets/Textures/Cube/Cube.dds", false);
+	SDL_RenderSetClipRect(GameRenderer, NULL);
+	SDL_SetRenderTarget(GameRenderer, NULL);
+	DirtyBricks.clear();
+}
 
-	/* Bricks */
-	for (int i = 0; i < BricksInGame.size(); i++)
+void GameMode::RenderStaticScene()
+{
+	int x, y, w, h;
+	GetBackgroundRect(WindowWidth, WindowHeight, x, y, w, h);
+	RenderTexture((float)x, (float)y, (float)w, (float)h, BackgroundTexture);
+	RenderBorder();
+	SubmitBatch();
+}
+
+void GameMode::BuildStaticLayer()
+{
+	PROFILE_ZONE("BuildStaticLayer");
+	bStaticLayerDirty = false;
+
+	if (!SDL_RenderTargetSupported(GameRenderer)) return;
+
+	if (StaticLayer == nullptr)
 	{
-		auto Brick = &BricksInGame[i];
-		RenderMinAndMaxTexture(Brick->brickBox.min, Brick->brickBox.max, Brick->Texture, false);
-		RenderMinAndMaxTexture(Brick->brickBox.min, Brick->brickBox.max, Brick->Texture, true);
+		StaticLayer = SDL_CreateTexture(GameRenderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, WindowWidth, WindowHeight);
+		if (StaticLayer == nullptr)
+		{
+			std::cerr << "Creating static layer failed: " << SDL_GetError() << std::endl;
+			return;
+		}
+
+		/* The layer covers the whole window, so it is copied without blending */
+		SDL_SetTextureBlendMode(StaticLayer, SDL_BLENDMODE_NONE);
 	}
 
-	// Borders  
+	SDL_SetRenderTarget(GameRenderer, StaticLayer);
+	SDL_SetRenderDrawColor(GameRenderer, 0, 0, 0, 255);
+	SDL_RenderClear(GameRenderer);
+	RenderStaticScene();
+	SDL_SetRenderTarget(GameRenderer, NULL);
+}
+
+void GameMode::RenderGameOver()
+{
 	RenderBorder();
+	SubmitBatch();
 
-	/* GameInfo */
-	RenderGameInfo(Border * WindowWidth, 4, "Level: ", LevelCounter + 1, false);
-	RenderGameInfo(Border * WindowWidth + WindowWidth * 0.175f, 4, "Lives: ", LifeCount, false);
-	RenderGameInfo(Border * WindowWidth + WindowWidth * 0.3f, 4, "Score: ", Score, false);
-	RenderGameInfo(Border * WindowWidth + WindowWidth * 0.425f, 4, "Time: ", int(Seconds), false);
+	std::string Text = Simulation.GetScore() == Simulation.GetMaxScore() ? "You WIN! Press Enter to start again!" : "GameOver! Press Enter to start again!";
 
+	if (Text != GameOverText)
+	{
+		GameOverText = Text;
+		GameOverLayout.Clear();
+
+		int TextWidth = GlyphsArial_24.Measure(Text);
+		int TextHeight = GlyphsArial_24.GetLineHeight();
+		GlyphsArial_24.Layout(Text, (float)((WindowWidth - TextWidth) / 2), (WindowHeight - Border * WindowWidth + TextHeight) / 2, { 0, 0, 0, 255 }, GameOverLayout);
+	}
+
+	GlyphsArial_24.Draw(GameRenderer, GameOverLayout);
+
+	SDL_RenderPresent(GameRenderer);
+	SDL_RenderClear(GameRenderer);
 }
 
-void GameMode::UploadLevel(const char* Level)
+void GameMode::Render()
 {
-	BricksLayout.clear();
-	BricksLayout.shrink_to_fit();
-	BackgroundPath.clear();
+	PROFILE_ZONE("Render");
 
-	tinyxml2::XMLDocument Document;
-	if (Document.LoadFile(Level) == XML_SUCCESS)
+	/* Paddle and cube are drawn between the last two fixed steps */
+	Vector2D Paddle = lerp(PreviousPaddle, Simulation.GetPaddle(), RenderAlpha);
+	Vector2D Cube = lerp(PreviousCube, Simulation.GetCube(), RenderAlpha);
+	/* Background and Borders */
 	{
-		XMLElement* LevelElement = Document.FirstChildElement("Level");
-		LevelElement->QueryIntAttribute("RowCount", &RowCount);
-		LevelElement->QueryIntAttribute("ColumnCount", &ColumnCount);
-		LevelElement->QueryIntAttribute("RowSpacing", &RowSpacing);
-		LevelElement->QueryIntAttribute("ColumnSpacing", &ColumnSpacing);
+		PROFILE_ZONE("Render Static Layer");
+		if (bStaticLayerDirty) BuildStaticLayer();
 
-		BackgroundPath = LevelElement->Attribute("BackgroundTexture");
+		if (StaticLayer != nullptr) SDL_RenderCopy(GameRenderer, StaticLayer, NULL, NULL);
+		else RenderStaticScene();
+	}
 
-		XMLElement* BrickTypesElement = LevelElement->FirstChildElement("BrickTypes");
-		std::vector<XMLElement*> BrickTypeElements;
+	/* Bricks */
+	{
+		PROFILE_ZONE("Render Bricks");
+		if (bBrickLayerDirty) BuildBrickLayer();
+		else UpdateBrickLayer();
 
-		for (XMLElement* BrickTypeElement = BrickTypesElement->FirstChildElement("BrickType"); BrickTypeElement != nullptr; BrickTypeElement = BrickTypeElement->NextSiblingElement("BrickType"))
+		if (BrickLayer != nullptr)
 		{
-			BrickTypeElements.push_back(BrickTypeElement);
+			SDL_RenderCopy(GameRenderer, BrickLayer, NULL, NULL);
 		}
 
-		for (int i = 0; i < BrickTypeElements.size(); i++)
+		else
 		{
-			BrickType Brick;
-
-			Brick.Id = BrickTypeElements.at(i)->Attribute("Id");
-			Brick.Texture = BrickTypeElements.at(i)->Attribute("Texture");
-			Brick.HitPoints = atoi(BrickTypeElements.at(i)->Attribute("HitPoints"));
-			Brick.HitSound = BrickTypeElements.at(i)->Attribute("HitSound");
-
-			if (i != BrickTypeElements.size() - 1)
+			const BrickStore& Bricks = Simulation.GetBricks();
+			for (int i = 0; i < Bricks.Size(); i++)
 			{
-				Brick.BreakSound = BrickTypeElements.at(i)->Attribute("BreakSound");
-				Brick.BreakScore = atoi(BrickTypeElements.at(i)->Attribute("BreakScore"));
+				if (Bricks.IsAlive(i)) RenderBrick(i);
 			}
+		}
+	}
 
-			else
-			{
-				Brick.BreakSound = "";
-				Brick.BreakScore = INT_MAX;
-			}
+	{
+		PROFILE_ZONE("Render Paddle");
 
-			LevelBricks.push_back(Brick);
-		}
+		/* Left Corner */
+		RenderMinAndSizeTexture(Paddle - PaddleSize * 0.5f, Vector2D{ PaddleCornerWidth, PaddleSize.y }, PaddleTexture, false);
 
-		XMLElement* BricksElement = LevelElement->FirstChildElement("Bricks");
-		std::string Bricks = BricksElement->GetText();
+		/* Right Corner */
+		RenderMinAndSizeTexture(Paddle + Vector2D{ PaddleSize.x * 0.5f - PaddleCornerWidth, PaddleSize.y * (-0.5f) }, Vector2D{ PaddleCornerWidth, PaddleSize.y }, PaddleTexture, false);
 
+		/* Paddle*/
+		RenderMinAndSizeTexture(Paddle - PaddleSize * 0.5f + Vector2D{ PaddleCornerWidth, 0 }, PaddleSize - Vector2D{ PaddleCornerWidth * 2, 0 }, PaddleTexture, false);
+	}
 
-		std::stringstream StringStream(Bricks);
-		std::string SingleLine;
+	/* Cube*/
+	{
+		PROFILE_ZONE("Render Cube");
+		RenderMinAndSizeTexture(Cube - CubeSize * 0.5f, CubeSize, CubeTexture, false);
+	}
 
-		while (std::getline(StringStream, SingleLine))
-		{
-			std::vector<char> SingleRow;
+	/* Paddle and cube in one draw call. Without a brick layer the bricks join them and their frames take a second call. */
+	SubmitBatch();
 
-			for (char Character : SingleLine)
-			{
-				if (Character != ' ')
-				{
-					SingleRow.push_back(Character);
-				}
-			}
+	/* GameInfo */
+	{
+		PROFILE_ZONE("Render HUD");
+		RenderHud();
+	}
 
-			BricksLayout.push_back(SingleRow);
-		}
+}
+
+void GameMode::UploadLevel(const LevelData& Level)
+{
+	PROFILE_ZONE("UploadLevel");
+
+	UploadedLevel = &Level;
+	BackgroundTexture = Textures.Load(Level.BackgroundPath);
+	bStaticLayerDirty = true;
+
+	BrickTextures.clear();
+	BrickHitSounds.clear();
+	BrickBreakSounds.clear();
+
+	for (const BrickType& Brick : Level.BrickTypes)
+	{
+		BrickTextures.push_back(Sprites.Add(Brick.Texture));
+		BrickHitSounds.push_back(Sounds.Load(Brick.HitSound));
+		BrickBreakSounds.push_back(Sounds.Load(Brick.BreakSound));
 	}
+
+	/* Repacks the atlas only if the level brought new brick textures */
+	Sprites.Build();
 }
@@ -4,30 +4,17 @@
 #include <iostream>
 #include <vector>
 #include "SDL_ttf.h"
+#include "TextureCache.h"
+#include "SpriteAtlas.h"
+#include "SpriteBatch.h"
+#include "GlyphAtlas.h"
+#include "SoundBank.h"
+#include "GameSimulation.h"
+#include "Clock.h"
+#include "LevelStreamer.h"
+#include "AssetPreload.h"
+#include "Profiler.h"
 #include <string>
-//
-union Vector2D
-{
-    struct { float x, y; };
-    float Values[2];
-};
-
-struct Box2D
-{
-    Vector2D min;
-    Vector2D max;
-};
-
-struct BrickType {
-    int HitPoints = 0;
-    int BreakScore = 0;
-    std::string Id = "";
-    std::string Texture = "";
-    std::string HitSound = "";
-    std::string BreakSound = "";
-
-    struct Box2D brickBox;
-};
 
 
 class GameMode : public GameModeBase
@@ -38,6 +25,18 @@ private:
     int WindowWidth;
     int WindowHeight;
 
+    /* Runs the simulation without Window, Renderer and audio device for HeadlessTicks fixed time steps */
+    bool bHeadless;
+    int HeadlessTicks;
+
+    /* The simulation advances in fixed steps of 1 / TickRate seconds. At most MaxCatchUpSteps run per frame, older time is dropped. */
+    int TickRate;
+    int MaxCatchUpSteps;
+    float FixedTimeStep;
+
+    /* Frame time not yet consumed by a fixed step */
+    float Accumulator;
+
     /* Forward declarations of Window and Renderer */
     struct SDL_Window* GameWindow;
     struct SDL_Renderer* GameRenderer;
@@ -45,81 +44,160 @@ private:
     TTF_Font* FontArial_16;
     TTF_Font* FontArial_24;
 
-    /* Attributes for placing Level elements */
+    /* Glyphs of both fonts, rasterized once. Text is drawn from them as batched quads. */
+    GlyphAtlas GlyphsArial_16;
+    GlyphAtlas GlyphsArial_24;
+
+    /* HUD text, laid out again only when one of the shown values changes */
+    TextLayout HudLayout;
+    int HudValues[4];
+
+    /* Game over message and its layout */
+    std::string GameOverText;
+    TextLayout GameOverLayout;
+
+    /* Textures decoded once and kept alive for the life of the Renderer */
+    TextureCache Textures;
+    int BackgroundTexture;
+
+    /* Background and border composed once per level, drawn with a single copy each frame */
+    struct SDL_Texture* StaticLayer;
+    bool bStaticLayerDirty;
+
+    /* Bricks and their frames, rebuilt when the bricks are reset and patched where a brick was removed */
+    struct SDL_Texture* BrickLayer;
+    bool bBrickLayerDirty;
+    std::vector<SimulationEvent> DirtyBricks;
+
+    /* Paddle, cube, border and brick textures share one atlas and are drawn through Batch */
+    SpriteAtlas Sprites;
+    SpriteBatch Batch;
+    int PaddleTexture;
+    int CubeTexture;
+    int BorderTexture;
+
+    /* Sounds loaded once, Update only enqueues them */
+    SoundBank Sounds;
+    int WallSound;
+    int PaddleSound;
+
+    /* Level documents played in order */
     std::vector<const char*> Levels;
-    int RowCount;
-    int ColumnCount;
-    int RowSpacing;
-    int ColumnSpacing;
-    std::string BackgroundPath;
-    std::vector<BrickType> LevelBricks;
-    std::vector<std::vector<char>> BricksLayout;
-    std::vector<BrickType> BricksInGame;
+
+    /* Prepares the level after the current one on a worker thread */
+    LevelStreamer Streamer;
+
+    /* The Game rules and state. GameMode only adds input, rendering and audio. */
+    GameSimulation Simulation;
+
+    /* Level whose textures and sounds are loaded, and the handles for each of its BrickTypes */
+    const LevelData* UploadedLevel;
+    std::vector<int> BrickTextures;
+    std::vector<int> BrickHitSounds;
+    std::vector<int> BrickBreakSounds;
 
     /* Updates the mouse position */
     float MouseX;
     float MouseY;
 
+    /* Time source of the main loop and the HUD clock. Headless runs use SimulatedClock, which advances by one time step per tick. */
+    PerformanceClock RealClock;
+    FakeClock SimulatedClock;
+    Clock* GameClock;
+
     /* Updates the time */
     float Time;
-    int startTime;
     float Seconds;
-    unsigned int BeforeTime;
-    unsigned int BeforeTimeForTime;
-    unsigned int TimeForTime;
+    double LastFrameTime;
+    double GameStartTime;
+
+    /* RealClock time when Init started, reported once as time to first frame when the first frame is presented */
+    double StartupTime;
+    bool bFirstFramePresented;
+
+    /* Paddle and cube before the last fixed step. Render interpolates from them to the current state by RenderAlpha. */
+    Vector2D PreviousPaddle;
+    Vector2D PreviousCube;
+    float RenderAlpha;
+
+    /* Set when the cube was placed rather than moved, e.g. after a lost life, so it is not interpolated across the jump */
+    bool bSnapInterpolation;
+
+    /* Chrome trace written when a capture started with F9 is stopped with F9 */
+    const char* TracePath;
 
     /* Monitors the state of the main loop */
     bool bQuit;
    
-    /* Center of the Game objects */
-    Vector2D Paddle;
-    Vector2D Cube;
-    Vector2D Brick;
-    Vector2D CubeDirection;
-    
-    /* Event tracking flags */
-    bool bLostLife;
-    bool bStartGame;
-    bool bGameOver;
-    bool bShouldPause;
-
-    int LifeCount;
-    int LevelCounter;
-    int Score;
-    int CurrentScore;
-    int MaxScore;
-    int MaxLevelScore;
-   
 protected:
-    /* Sets all Bricks to the values specified in the Level and adds the Bricks to a BricksInGame vector */
-    void SetBricks();
+    /* Initializes SDL, audio, TTF, Window and Renderer. Skipped in headless mode. */
+    void InitBackends();
+
+    /* Steps the simulation as fast as possible with a fixed time step and an automatic paddle, then prints statistics */
+    void RunHeadless();
+
+    /* Starts a profiler capture, or stops it and writes the trace to TracePath */
+    void ToggleProfiling();
+
+    /* Runs as many fixed steps as the frame time allows and updates RenderAlpha */
+    void StepFixed(float FrameTime);
+
+    /* Plays sounds and loads level assets for the events of the last Simulation call */
+    void ProcessEvents();
+
+    /* Loads every level and the assets they reference on a thread pool before the first frame, then uploads them on this thread */
+    void Preload();
 
-    /* Draws a frame for each Brick */
-    void RenderRectFrame(float x, float y, float w, float h, struct SDL_Color Color);
+    /* Hands a level finished by the Streamer to the simulation and uploads its textures and sounds, so starting it later loads nothing */
+    void AdoptStreamedLevel();
 
     /* Draws texture for all Game objects */
-    void RenderTexture(float x, float y, float w, float h, std::string Texture);
+    void RenderTexture(float x, float y, float w, float h, int Texture);
 
-    /* Additional method for drawing objects from the initial position to the size of the object */
-    void RenderMinAndSizeTexture(Vector2D worldMin, Vector2D worldSize, std::string Texture, bool Frame);
+    /* Adopts a new window size: drops resampled textures and the cached layers so they are rebuilt at the new size */
+    void OnWindowResized(int Width, int Height);
 
-    /* Additional method for drawing objects from the initial position to the specified maximum position */
-    void RenderMinAndMaxTexture(Vector2D worldMin, Vector2D worldMax, std::string Texture, bool Frame);
+    /* Queues an atlas sprite, or its frame, from the initial position to the size of the object. SubmitBatch draws everything queued. */
+    void RenderMinAndSizeTexture(Vector2D worldMin, Vector2D worldSize, int Texture, bool Frame);
 
-    /* Draws left, right and top border */
+    /* Queues an atlas sprite, or its frame, from the initial position to the specified maximum position */
+    void RenderMinAndMaxTexture(Vector2D worldMin, Vector2D worldMax, int Texture, bool Frame);
+
+    /* Queues left, right and top border */
     void RenderBorder();
 
+    /* Draws all queued sprites and frames */
+    void SubmitBatch();
+
+    /* Queues the sprite and frame of a brick */
+    void RenderBrick(int Brick);
+
+    /* Pixels covered by a brick box including its frame */
+    struct SDL_Rect GetBrickPixelRect(const Box2D& Box) const;
+
+    /* Redraws the whole brick layer texture. Without render target support the bricks are queued every frame instead. */
+    void BuildBrickLayer();
+
+    /* Clears the rectangles of the bricks removed by DirtyBricks in the brick layer and redraws the bricks that are left there */
+    void UpdateBrickLayer();
+
+    /* Draws background and border to the current render target */
+    void RenderStaticScene();
+
+    /* Redraws the static layer texture. Without render target support the static scene is drawn every frame instead. */
+    void BuildStaticLayer();
+
     /* Draws information about the Game such as the level the player is currently at, the current score etc. */
-    void RenderGameInfo(float x, float y, std::string Text, int value, bool GameOver);
+    void RenderHud();
 
     /* Draws information about whether the player lost or won */
     void RenderGameOver();
 
-    /* Uploads levels from XML documents */
-    void UploadLevel(const char* Level);
+    /* Loads the background, brick textures and brick sounds of a level */
+    void UploadLevel(const LevelData& Level);
 
 public:
-    GameMode(int WindowWidth, int WindowHeight);
+    GameMode(int WindowWidth, int WindowHeight, bool bHeadless = false, int HeadlessTicks = 0, int TickRate = 120, int MaxCatchUpSteps = 8);
 
     /* Initializes SDL, Window, Renderer etc. */
     void Init();
@@ -138,6 +216,3 @@ public:
 
     void Run() override;
 };
-
-
-
@@ -0,0 +1,323 @@
+#include "GameSimulation.h"
+#include <algorithm>
+
+GameSimulation::GameSimulation() :
+	SweepBricks(GetSweepBricks()),
+	Paddle({ 0.5f, PaddleY }),
+	Cube({ 0.5f, PaddleY - PaddleSize.y }),
+	CubeDirection({ 0, -1 }),
+	bGameOver(false),
+	bShouldPause(true),
+	LifeCount(0),
+	LevelCounter(0),
+	Score(0),
+	CurrentScore(0),
+	MaxScore(0),
+	MaxLevelScore(0)
+{
+}
+
+void GameSimulation::Init(const std::vector<const char*>& LevelPaths)
+{
+	this->LevelPaths = LevelPaths;
+	Levels.assign(LevelPaths.size(), nullptr);
+}
+
+void GameSimulation::SetLevel(int Index, std::shared_ptr<const LevelData> Level)
+{
+	Levels.at(Index) = Level;
+}
+
+void GetBackgroundRect(int WindowWidth, int WindowHeight, int& x, int& y, int& w, int& h)
+{
+	x = (int)(Border * WindowWidth);
+	y = (int)(Border * WindowHeight - 10);
+	w = (int)(WindowWidth - 2 * Border * WindowWidth);
+	h = (int)(WindowHeight - Border * WindowHeight + 10);
+}
+
+void GameSimulation::Emit(SimulationEventType Type, int BrickType, int Brick)
+{
+	Box2D BrickBox = { { 0, 0 }, { 0, 0 } };
+	if (Brick >= 0) BrickBox = { { Bricks.MinX[Brick], Bricks.MinY[Brick] }, { Bricks.MaxX[Brick], Bricks.MaxY[Brick] } };
+
+	Events.push_back({ Type, BrickType, Brick, BrickBox });
+}
+
+void GameSimulation::SetBricks()
+{
+	MaxLevelScore = 0;
+	Vector2D BrickSize = { (1 - 2 * Border - (Level->ColumnCount + 1) * 0.0011875f) / Level->ColumnCount, WorldSize.y * 0.025f };
+	float TopOffset = BrickSize.y * 4;
+
+	const BrickLayout& Layout = Level->BricksLayout;
+	int GridColumns = std::max(Level->ColumnCount, Layout.Width);
+
+	InitialBricks.Init(Layout.Height, GridColumns);
+	Grid.Init(Layout.Height, GridColumns, Border + 0.0011875f, Border + TopOffset, BrickSize.x + 0.0011875f, BrickSize.y + 0.0022875f);
+
+	for (int i = 0; i < Layout.Height; i++)
+	{
+		const char* Row = Layout.GetRow(i);
+		int ColumnCounter = 1;
+
+		for (int j = 0; j < Layout.Width; j++)
+		{
+			/* Sets Bricks position */
+			Vector2D BrickMin = Vector2D{ Border + j * BrickSize.x + ColumnCounter * 0.0011875f, Border + TopOffset + i * BrickSize.y + i * 0.0022875f };
+			Vector2D BrickMax = BrickMin + BrickSize;
+
+			ColumnCounter++;
+
+			/* '_' and cells that match no BrickType stay empty */
+			unsigned char Type = Level->CellTypes[(unsigned char)Row[j]];
+			if (Type == NoBrickType) continue;
+
+			MaxLevelScore += Level->BrickTypes.at(Type).BreakScore;
+			InitialBricks.Add(i, j, BrickMin.x, BrickMin.y, BrickMax.x, BrickMax.y, Level->BrickTypes.at(Type).HitPoints, Type);
+		}
+	}
+}
+
+void GameSimulation::NextLevel()
+{
+	bShouldPause = true;
+	CurrentScore = 0;
+
+	if (!Levels.at(LevelCounter))
+	{
+		auto Loaded = std::make_shared<LevelData>();
+		LoadLevel(LevelPaths.at(LevelCounter), *Loaded);
+		Levels.at(LevelCounter) = Loaded;
+	}
+
+	Level = Levels.at(LevelCounter);
+	SetBricks();
+	ResetLevel();
+	Emit(EventLevelStarted);
+}
+
+void GameSimulation::ResetLevel()
+{
+	/* Resets positions of all Game objects */
+	Paddle = { 0.5f, PaddleY };
+	Cube = { 0.5f, PaddleY - PaddleSize.y };
+
+	/* Same sized vectors are copied in place, so restarting a level after a lost life does not allocate */
+	Bricks = InitialBricks;
+	MaxScore += MaxLevelScore;
+
+	if (!bShouldPause) CubeDirection = normalize({ 0, -1 });
+}
+
+void GameSimulation::ResetGame()
+{
+	LifeCount = 4;
+	LevelCounter = 0;
+	Score = 0;
+	CurrentScore = 0;
+	MaxScore = 0;
+	NextLevel();
+}
+
+void GameSimulation::Update(float PaddleX, float TimeStep)
+{
+	Paddle.x = PaddleX;
+	Paddle.y = PaddleY;
+
+	/* Paddle and Wall collision */
+	if (Paddle.x - PaddleSize.x * 0.5f < Border)
+	{
+		Paddle.x = PaddleSize.x * 0.5f + Border;
+	}
+
+	else if (Paddle.x + PaddleSize.x * 0.5f > 1 - Border)
+	{
+		Paddle.x = 1 - Border - PaddleSize.x * 0.5f;
+	}
+
+	float TimeAllowed = TimeStep;
+	int HitIndex = -1;
+	bool bCollisionDetected = false;
+	Vector2D ChangeDirection = CubeDirection;
+
+	Box2D CubeBox = { Cube - CubeSize * 0.5f, Cube + CubeSize * 0.5f };
+	Box2D PaddleBox = { Paddle - PaddleSize * 0.5f, Paddle + PaddleSize * 0.5f };
+
+	{
+		/* Cube and Wall collision */
+		if (CubeDirection.x > 0)
+		{
+			float TimeOfHit = (1 - Border - CubeBox.max.x) / CubeDirection.x;
+			if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
+			{
+				TimeAllowed = TimeOfHit;
+				ChangeDirection = { -CubeDirection.x, CubeDirection.y };
+				bCollisionDetected = true;
+				HitIndex = -1;
+				Emit(EventHitWall);
+			}
+		}
+
+		else if (CubeDirection.x < 0)
+		{
+			float TimeOfHit = (Border - CubeBox.min.x) / CubeDirection.x;
+			if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
+			{
+				TimeAllowed = TimeOfHit;
+				ChangeDirection = { -CubeDirection.x, CubeDirection.y };
+				bCollisionDetected = true;
+				HitIndex = -1;
+				Emit(EventHitWall);
+			}
+		}
+
+		if (CubeDirection.y < 0)
+		{
+			float TimeOfHit = (Border - CubeBox.min.y) / CubeDirection.y;
+			if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
+			{
+				TimeAllowed = TimeOfHit;
+				ChangeDirection = { CubeDirection.x, -CubeDirection.y };
+				bCollisionDetected = true;
+				HitIndex = -1;
+				Emit(EventHitWall);
+			}
+		}
+
+		if (CubeDirection.y > 0)
+		{
+			float TimeOfHit = (PaddleBox.min.y - CubeBox.max.y) / CubeDirection.y;
+
+			if ((TimeOfHit >= 0) && (TimeOfHit < TimeAllowed))
+			{
+				float NewCube = Cube.x + CubeDirection.x * TimeOfHit;
+				float NewCubeMin = CubeBox.min.x + CubeDirection.x * TimeOfHit;
+				float NewCubeMax = CubeBox.max.x + CubeDirection.x * TimeOfHit;
+
+				/* Cube and Paddle collision */
+				if ((NewCubeMax >= PaddleBox.min.x) && (PaddleBox.max.x >= NewCubeMin))
+				{
+					Emit(EventHitPaddle);
+					if (NewCubeMin < PaddleBox.min.x + PaddleCornerWidth)
+					{
+						ChangeDirection = normalize({ -1,-1 });
+					}
+
+					else if (NewCubeMax > PaddleBox.max.x - PaddleCornerWidth)
+					{
+						ChangeDirection = normalize({ 1,-1 });
+					}
+
+					else if (NewCube <= Paddle.x)
+					{
+						ChangeDirection = normalize({ 0,-1 });
+					}
+
+					else
+					{
+						ChangeDirection = normalize({ 1,-1 });
+					}
+
+					TimeAllowed = TimeOfHit;
+					bCollisionDetected = true;
+					HitIndex = -1;
+
+				}
+			}
+		}
+
+		
+		/* Cube and Bricks collision. Only bricks in the grid cells crossed by the cube are tested. */
+		Grid.Query(CubeBox.min.x, CubeBox.min.y, CubeBox.max.x, CubeBox.max.y, CubeDirection.x, CubeDirection.y, TimeAllowed, CollisionSpans);
+
+		SweepInput Sweep = MakeSweepInput(CubeBox.min.x, CubeBox.min.y, CubeBox.max.x, CubeBox.max.y, CubeDirection.x, CubeDirection.y);
+		SweepHit Hit = { TimeAllowed, -1, 0 };
+
+		for (const BrickSpan& Span : CollisionSpans)
+		{
+			SweepBricks(Bricks, Span.First, Span.Last, Sweep, Hit);
+		}
+
+		if (Hit.Index != -1)
+		{
+			TimeAllowed = Hit.Time;
+			ChangeDirection = Hit.Axis == 0 ? Vector2D{ -CubeDirection.x, CubeDirection.y } : Vector2D{ CubeDirection.x, -CubeDirection.y };
+			bCollisionDetected = true;
+			HitIndex = Hit.Index;
+		}
+
+		// Slow down cube speed *0.6f
+		Cube = Cube + CubeDirection * TimeAllowed * 0.6f;
+
+		if (bCollisionDetected)
+		{
+			CubeDirection = ChangeDirection;
+
+			if (HitIndex != -1)
+			{
+				int TypeIndex = Bricks.TypeIndex[HitIndex];
+				const BrickType& Type = Level->BrickTypes.at(TypeIndex);
+
+				if (Bricks.HitPoints[HitIndex] > 0)
+				{
+					Bricks.HitPoints[HitIndex]--;
+					Emit(EventHitBrick, TypeIndex, HitIndex);
+				}
+
+				if (Bricks.HitPoints[HitIndex] == 0)
+				{
+					Emit(EventBreakBrick, TypeIndex, HitIndex);
+					CurrentScore += Type.BreakScore;
+					Score += Type.BreakScore;
+					Bricks.Remove(HitIndex);
+
+
+					if (CurrentScore == MaxLevelScore && LevelCounter < LevelPaths.size() - 1)
+					{
+						bShouldPause = true;
+						if (LevelCounter <= 1) LevelCounter++;
+						NextLevel();
+					}
+
+					else if (CurrentScore == MaxLevelScore && LevelCounter == LevelPaths.size() - 1)
+					{
+						bGameOver = true;
+						Emit(EventGameOver);
+					}
+
+				}
+			}
+		}
+
+		if (CubeBox.min.y >= WorldSize.y)
+		{
+			/* The final level, lives and score stay in place until the owner starts the next game with ResetGame */
+			if (LifeCount == 0)
+			{
+				bGameOver = true;
+				bShouldPause = true;
+				Emit(EventGameOver);
+			}
+
+			else if (LifeCount > 0)
+			{
+				Score = Score - CurrentScore;
+				MaxScore = Score;
+				CurrentScore = 0;
+				LifeCount--;
+				bShouldPause = true;
+				Emit(EventLostLife);
+				ResetLevel();
+			}
+		}
+
+	}
+
+}
+
+void GameSimulation::Release()
+{
+	bShouldPause = false;
+	CubeDirection = normalize({ 0, -1 });
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include "Vector2D.h"
+#include "LevelData.h"
+#include "BrickGrid.h"
+#include "BrickStore.h"
+#include "BrickSweep.h"
+#include <memory>
+#include <vector>
+
+const Vector2D PaddleSize = { 0.1f, 0.025f };
+const Vector2D CubeSize = { 0.015f, 0.02f };
+const Vector2D WorldSize = { 1.0f, 5.0f / 4.0f };
+const float PaddleY = 0.9f * WorldSize.y;
+const float Border = 0.05f;
+const float PaddleCornerWidth = PaddleSize.x * 0.1f;
+
+/* Pixel rectangle the level background is drawn to in a window of the given size. Shared with the asset cooker, which pre-scales backgrounds to it. */
+void GetBackgroundRect(int WindowWidth, int WindowHeight, int& x, int& y, int& w, int& h);
+
+/* Something that happened during a simulation call. The owner of the simulation reacts to them, e.g. by playing sounds. */
+enum SimulationEventType
+{
+    EventHitWall,
+    EventHitPaddle,
+    EventHitBrick,
+    EventBreakBrick,
+    EventLostLife,
+    EventLevelStarted,
+    EventGameOver
+};
+
+struct SimulationEvent
+{
+    SimulationEventType Type;
+
+    /* Index into the BrickTypes of the current level for brick events, -1 otherwise */
+    int BrickType;
+
+    /* Slot of the brick in the BrickStore for brick events, -1 otherwise */
+    int Brick;
+
+    /* World box of the brick for brick events. Taken when the event is emitted, so it stays valid after the brick is removed. */
+    Box2D BrickBox;
+};
+
+/* The Breakout rules: paddle, cube, bricks, lives, score and levels. Does not depend on SDL, so any number of games can run without a window. */
+class GameSimulation
+{
+
+private:
+    /* Level documents and the levels loaded from them. Levels are loaded on first use unless they were set beforehand. */
+    std::vector<const char*> LevelPaths;
+    std::vector<std::shared_ptr<const LevelData>> Levels;
+    std::shared_ptr<const LevelData> Level;
+
+    /* Bricks in the game, indexed by layout cell. TypeIndex points into the BrickTypes of the current level. */
+    BrickStore Bricks;
+
+    /* Bricks as the current level starts, built once per level by SetBricks and copied over Bricks whenever the level restarts */
+    BrickStore InitialBricks;
+
+    /* Broadphase over the layout cells */
+    BrickGrid Grid;
+    std::vector<BrickSpan> CollisionSpans;
+
+    /* Narrowphase kernel selected for the CPU */
+    SweepBricksFunction SweepBricks;
+
+    /* Center of the Game objects */
+    Vector2D Paddle;
+    Vector2D Cube;
+    Vector2D CubeDirection;
+
+    /* Event tracking flags */
+    bool bGameOver;
+    bool bShouldPause;
+
+    int LifeCount;
+    int LevelCounter;
+    int Score;
+    int CurrentScore;
+    int MaxScore;
+    int MaxLevelScore;
+
+    /* Events since the last ClearEvents */
+    std::vector<SimulationEvent> Events;
+
+protected:
+    /* Builds InitialBricks and the broadphase grid from the layout of the Level */
+    void SetBricks();
+
+    void Emit(SimulationEventType Type, int BrickType = -1, int Brick = -1);
+
+public:
+    GameSimulation();
+
+    /* Sets the level documents played in order */
+    void Init(const std::vector<const char*>& LevelPaths);
+
+    /* Provides an already loaded level, so games sharing the same levels parse them only once */
+    void SetLevel(int Index, std::shared_ptr<const LevelData> Level);
+
+    void ResetGame();
+
+    void NextLevel();
+
+    void ResetLevel();
+
+    /* Releases the paused cube straight up */
+    void Release();
+
+    /* Leaves the game over state. ResetGame starts the next game. */
+    void ClearGameOver() { bGameOver = false; }
+
+    /* Moves the paddle to PaddleX (in world units) and advances the cube by TimeStep. After EventGameOver the game keeps its final state until ResetGame. */
+    void Update(float PaddleX, float TimeStep);
+
+    const std::vector<SimulationEvent>& GetEvents() const { return Events; }
+    void ClearEvents() { Events.clear(); }
+
+    const LevelData* GetLevel() const { return Level.get(); }
+    const BrickStore& GetBricks() const { return Bricks; }
+    SweepBricksFunction GetSweepKernel() const { return SweepBricks; }
+    Vector2D GetPaddle() const { return Paddle; }
+    Vector2D GetCube() const { return Cube; }
+    bool IsPaused() const { return bShouldPause; }
+    bool IsGameOver() const { return bGameOver; }
+    int GetLives() const { return LifeCount; }
+    int GetLevelIndex() const { return LevelCounter; }
+    int GetLevelCount() const { return (int)LevelPaths.size(); }
+    bool HasLevel(int Index) const { return Levels.at(Index) != nullptr; }
+    int GetScore() const { return Score; }
+    int GetCurrentScore() const { return CurrentScore; }
+    int GetMaxScore() const { return MaxScore; }
+    int GetMaxLevelScore() const { return MaxLevelScore; }
+};
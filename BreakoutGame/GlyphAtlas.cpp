@@ -0,0 +1,173 @@
+#include "GlyphAtlas.h"
+#include <algorithm>
+#include <iostream>
+
+/* Glyphs are packed into rows of this width */
+const int GlyphAtlasWidth = 512;
+
+GlyphAtlas::GlyphAtlas() :
+	Texture(nullptr),
+	Glyphs(),
+	LineHeight(0)
+{
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+	Clear();
+}
+
+void GlyphAtlas::Init(SDL_Renderer* Renderer, TTF_Font* Font)
+{
+	Clear();
+	if (Renderer == nullptr || Font == nullptr) return;
+
+	LineHeight = TTF_FontHeight(Font);
+
+	/* Rasterize every glyph the way TTF_RenderText_Solid draws it, converted to RGBA so the color key becomes alpha */
+	const int GlyphCount = LastGlyph - FirstGlyph + 1;
+	SDL_Surface* Surfaces[GlyphCount] = {};
+	const SDL_Color White = { 255, 255, 255, 255 };
+
+	int PositionX[GlyphCount];
+	int PositionY[GlyphCount];
+	int ShelfX = 0;
+	int ShelfY = 0;
+	int ShelfHeight = 0;
+
+	for (int i = 0; i < GlyphCount; i++)
+	{
+		char Text[2] = { (char)(FirstGlyph + i), 0 };
+		int Advance = 0;
+		TTF_GlyphMetrics(Font, (Uint16)Text[0], NULL, NULL, NULL, NULL, &Advance);
+		Glyphs[i].Advance = Advance;
+
+		SDL_Surface* Rendered = TTF_RenderText_Solid(Font, Text, White);
+		if (Rendered == nullptr) continue;
+
+		Surfaces[i] = SDL_ConvertSurfaceFormat(Rendered, SDL_PIXELFORMAT_RGBA32, 0);
+		SDL_FreeSurface(Rendered);
+		if (Surfaces[i] == nullptr) continue;
+
+		/* One pixel gap so linear filtering never samples a neighbouring glyph */
+		if (ShelfX + Surfaces[i]->w + 1 > GlyphAtlasWidth)
+		{
+			ShelfY += ShelfHeight + 1;
+			ShelfX = 0;
+			ShelfHeight = 0;
+		}
+
+		PositionX[i] = ShelfX;
+		PositionY[i] = ShelfY;
+		ShelfX += Surfaces[i]->w + 1;
+		ShelfHeight = std::max(ShelfHeight, Surfaces[i]->h);
+	}
+
+	int Height = 1;
+	while (Height < ShelfY + ShelfHeight) Height *= 2;
+
+	SDL_Surface* AtlasSurface = SDL_CreateRGBSurfaceWithFormat(0, GlyphAtlasWidth, Height, 32, SDL_PIXELFORMAT_RGBA32);
+	if (AtlasSurface == nullptr)
+	{
+		std::cerr << "Creating glyph atlas failed: " << SDL_GetError() << std::endl;
+	}
+
+	for (int i = 0; i < GlyphCount; i++)
+	{
+		if (Surfaces[i] == nullptr) continue;
+
+		if (AtlasSurface != nullptr)
+		{
+			SDL_Rect Destination = { PositionX[i], PositionY[i], Surfaces[i]->w, Surfaces[i]->h };
+			SDL_SetSurfaceBlendMode(Surfaces[i], SDL_BLENDMODE_NONE);
+			SDL_BlitSurface(Surfaces[i], NULL, AtlasSurface, &Destination);
+
+			Glyphs[i].Rect = { (float)PositionX[i] / GlyphAtlasWidth, (float)PositionY[i] / Height, (float)(PositionX[i] + Surfaces[i]->w) / GlyphAtlasWidth, (float)(PositionY[i] + Surfaces[i]->h) / Height };
+			Glyphs[i].Width = Surfaces[i]->w;
+			Glyphs[i].Height = Surfaces[i]->h;
+		}
+
+		SDL_FreeSurface(Surfaces[i]);
+	}
+
+	if (AtlasSurface == nullptr) return;
+
+	Texture = SDL_CreateTextureFromSurface(Renderer, AtlasSurface);
+	SDL_FreeSurface(AtlasSurface);
+
+	if (Texture == nullptr)
+	{
+		std::cerr << "Creating glyph atlas texture failed: " << SDL_GetError() << std::endl;
+		return;
+	}
+
+	SDL_SetTextureBlendMode(Texture, SDL_BLENDMODE_BLEND);
+}
+
+int GlyphAtlas::Layout(const std::string& Text, float x, float y, SDL_Color Color, TextLayout& Layout) const
+{
+	if (Texture == nullptr) return 0;
+
+	int PenX = 0;
+
+	for (char Character : Text)
+	{
+		if (Character < FirstGlyph || Character > LastGlyph) continue;
+
+		const Glyph& Current = Glyphs[Character - FirstGlyph];
+
+		if (Current.Width > 0)
+		{
+			float Left = x + PenX;
+			float Right = Left + Current.Width;
+			float Bottom = y + Current.Height;
+			int First = (int)Layout.Vertices.size();
+
+			Layout.Vertices.push_back({ { Left, y }, Color, { Current.Rect.U0, Current.Rect.V0 } });
+			Layout.Vertices.push_back({ { Right, y }, Color, { Current.Rect.U1, Current.Rect.V0 } });
+			Layout.Vertices.push_back({ { Right, Bottom }, Color, { Current.Rect.U1, Current.Rect.V1 } });
+			Layout.Vertices.push_back({ { Left, Bottom }, Color, { Current.Rect.U0, Current.Rect.V1 } });
+
+			int QuadIndices[6] = { First, First + 1, First + 2, First, First + 2, First + 3 };
+			Layout.Indices.insert(Layout.Indices.end(), QuadIndices, QuadIndices + 6);
+		}
+
+		/* A single rendered glyph is as wide as its advance */
+		PenX += std::max(Current.Width, Current.Advance);
+	}
+
+	return PenX;
+}
+
+int GlyphAtlas::Measure(const std::string& Text) const
+{
+	int Width = 0;
+
+	for (char Character : Text)
+	{
+		if (Character < FirstGlyph || Character > LastGlyph) continue;
+
+		const Glyph& Current = Glyphs[Character - FirstGlyph];
+		Width += std::max(Current.Width, Current.Advance);
+	}
+
+	return Width;
+}
+
+void GlyphAtlas::Draw(SDL_Renderer* Renderer, const TextLayout& Layout) const
+{
+	if (Texture == nullptr || Layout.Indices.empty()) return;
+	SDL_RenderGeometry(Renderer, Texture, Layout.Vertices.data(), (int)Layout.Vertices.size(), Layout.Indices.data(), (int)Layout.Indices.size());
+}
+
+void GlyphAtlas::Clear()
+{
+	if (Texture != nullptr) SDL_DestroyTexture(Texture);
+	Texture = nullptr;
+	LineHeight = 0;
+
+	for (Glyph& Current : Glyphs)
+	{
+		Current = Glyph();
+	}
+}
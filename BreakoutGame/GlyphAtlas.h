@@ -0,0 +1,58 @@
+#pragma once
+#include "SDL.h"
+#include "SDL_ttf.h"
+#include "SpriteAtlas.h"
+#include <string>
+#include <vector>
+
+/* Glyph quads of one or more strings, ready to be drawn with a single call */
+struct TextLayout
+{
+    std::vector<SDL_Vertex> Vertices;
+    std::vector<int> Indices;
+
+    void Clear() { Vertices.clear(); Indices.clear(); }
+};
+
+/* The printable ASCII glyphs of one font and size, rasterized once into a texture */
+class GlyphAtlas
+{
+
+private:
+    static const char FirstGlyph = ' ';
+    static const char LastGlyph = '~';
+
+    struct Glyph
+    {
+        /* Zero sized for glyphs without pixels, e.g. space */
+        SpriteRect Rect;
+        int Width;
+        int Height;
+        int Advance;
+    };
+
+    struct SDL_Texture* Texture;
+    Glyph Glyphs[LastGlyph - FirstGlyph + 1];
+    int LineHeight;
+
+public:
+    GlyphAtlas();
+    ~GlyphAtlas();
+
+    /* Rasterizes all glyphs of Font in white, text color is applied per vertex. Without a Font or Renderer every layout stays empty. */
+    void Init(SDL_Renderer* Renderer, TTF_Font* Font);
+
+    /* Appends the quads of Text with its top left corner at x, y to Layout. Returns the width of the text in pixels. */
+    int Layout(const std::string& Text, float x, float y, SDL_Color Color, TextLayout& Layout) const;
+
+    /* Width of Text in pixels */
+    int Measure(const std::string& Text) const;
+
+    int GetLineHeight() const { return LineHeight; }
+
+    /* Draws a layout with one SDL_RenderGeometry call */
+    void Draw(SDL_Renderer* Renderer, const TextLayout& Layout) const;
+
+    /* Destroys the glyph texture. Must be called before the Renderer is destroyed. */
+    void Clear();
+};
@@ -0,0 +1,147 @@
+#include "ImageResampler.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define IMAGERESAMPLER_X86 1
+#include <emmintrin.h>
+#endif
+
+/* One RGBA pixel in floats. On x86 the four channels live in one SSE register, so every filter tap is a single multiply-add. */
+#ifdef IMAGERESAMPLER_X86
+typedef __m128 Pixel4;
+static inline Pixel4 PixelZero() { return _mm_setzero_ps(); }
+static inline Pixel4 PixelLoad(const float* Source) { return _mm_loadu_ps(Source); }
+static inline void PixelStore(float* Destination, Pixel4 Value) { _mm_storeu_ps(Destination, Value); }
+static inline Pixel4 PixelMulAdd(Pixel4 Sum, Pixel4 Value, float Weight) { return _mm_add_ps(Sum, _mm_mul_ps(Value, _mm_set1_ps(Weight))); }
+#else
+struct Pixel4 { float Values[4]; };
+static inline Pixel4 PixelZero() { return { { 0, 0, 0, 0 } }; }
+static inline Pixel4 PixelLoad(const float* Source) { return { { Source[0], Source[1], Source[2], Source[3] } }; }
+static inline void PixelStore(float* Destination, Pixel4 Value) { for (int i = 0; i < 4; i++) Destination[i] = Value.Values[i]; }
+static inline Pixel4 PixelMulAdd(Pixel4 Sum, Pixel4 Value, float Weight) { for (int i = 0; i < 4; i++) Sum.Values[i] += Value.Values[i] * Weight; return Sum; }
+#endif
+
+/* Source pixels and weights that make up one output pixel along one axis */
+struct FilterTaps
+{
+    std::vector<int> First;
+    std::vector<int> Count;
+    std::vector<int> Indices;
+    std::vector<float> Weights;
+};
+
+static void MakeTaps(int SourceSize, int TargetSize, FilterTaps& Taps)
+{
+	float Scale = (float)SourceSize / TargetSize;
+
+	for (int i = 0; i < TargetSize; i++)
+	{
+		Taps.First.push_back((int)Taps.Indices.size());
+
+		if (Scale > 1.0f)
+		{
+			/* Box: every source pixel weighted by how much of it the output pixel covers */
+			float Begin = i * Scale;
+			float End = (i + 1) * Scale;
+
+			for (int s = (int)Begin; s < SourceSize && s < End; s++)
+			{
+				float Overlap = std::min(End, s + 1.0f) - std::max(Begin, (float)s);
+				if (Overlap <= 0) continue;
+
+				Taps.Indices.push_back(s);
+				Taps.Weights.push_back(Overlap / Scale);
+			}
+		}
+
+		else
+		{
+			/* Bilinear between the two nearest source pixel centers */
+			float Center = (i + 0.5f) * Scale - 0.5f;
+			int Left = (int)std::floor(Center);
+			float Fraction = Center - Left;
+
+			Taps.Indices.push_back(std::min(std::max(Left, 0), SourceSize - 1));
+			Taps.Weights.push_back(1.0f - Fraction);
+			Taps.Indices.push_back(std::min(std::max(Left + 1, 0), SourceSize - 1));
+			Taps.Weights.push_back(Fraction);
+		}
+
+		Taps.Count.push_back((int)Taps.Indices.size() - Taps.First.back());
+	}
+}
+
+void ResampleImage(const DecodedImage& Source, int Width, int Height, DecodedImage& Result)
+{
+	Result.Width = Width;
+	Result.Height = Height;
+	Result.Pixels.resize((size_t)Width * Height * 4);
+	if (Width <= 0 || Height <= 0 || Source.Width <= 0 || Source.Height <= 0) return;
+
+	FilterTaps Horizontal;
+	FilterTaps Vertical;
+	MakeTaps(Source.Width, Width, Horizontal);
+	MakeTaps(Source.Height, Height, Vertical);
+
+	/* Premultiplied float copy of the source */
+	std::vector<float> Premultiplied((size_t)Source.Width * Source.Height * 4);
+	for (size_t i = 0; i < (size_t)Source.Width * Source.Height; i++)
+	{
+		float Alpha = Source.Pixels[i * 4 + 3] * (1.0f / 255.0f);
+		Premultiplied[i * 4 + 0] = Source.Pixels[i * 4 + 0] * Alpha;
+		Premultiplied[i * 4 + 1] = Source.Pixels[i * 4 + 1] * Alpha;
+		Premultiplied[i * 4 + 2] = Source.Pixels[i * 4 + 2] * Alpha;
+		Premultiplied[i * 4 + 3] = Source.Pixels[i * 4 + 3];
+	}
+
+	/* Horizontal pass into a Width x Source.Height buffer */
+	std::vector<float> Rows((size_t)Width * Source.Height * 4);
+	for (int y = 0; y < Source.Height; y++)
+	{
+		const float* SourceRow = &Premultiplied[(size_t)y * Source.Width * 4];
+		float* TargetRow = &Rows[(size_t)y * Width * 4];
+
+		for (int x = 0; x < Width; x++)
+		{
+			Pixel4 Sum = PixelZero();
+			for (int t = Horizontal.First[x]; t < Horizontal.First[x] + Horizontal.Count[x]; t++)
+			{
+				Sum = PixelMulAdd(Sum, PixelLoad(SourceRow + Horizontal.Indices[t] * 4), Horizontal.Weights[t]);
+			}
+
+			PixelStore(TargetRow + x * 4, Sum);
+		}
+	}
+
+	/* Vertical pass, then back to 8 bit straight alpha */
+	std::vector<float> Line((size_t)Width * 4);
+	for (int y = 0; y < Height; y++)
+	{
+		for (int x = 0; x < Width; x++)
+		{
+			Pixel4 Sum = PixelZero();
+			for (int t = Vertical.First[y]; t < Vertical.First[y] + Vertical.Count[y]; t++)
+			{
+				Sum = PixelMulAdd(Sum, PixelLoad(&Rows[((size_t)Vertical.Indices[t] * Width + x) * 4]), Vertical.Weights[t]);
+			}
+
+			PixelStore(&Line[x * 4], Sum);
+		}
+
+		unsigned char* Target = &Result.Pixels[(size_t)y * Width * 4];
+		for (int x = 0; x < Width; x++)
+		{
+			float Alpha = Line[x * 4 + 3];
+			float Unpremultiply = Alpha > 0.0f ? 255.0f / Alpha : 0.0f;
+
+			for (int c = 0; c < 3; c++)
+			{
+				Target[x * 4 + c] = (unsigned char)std::min(Line[x * 4 + c] * Unpremultiply + 0.5f, 255.0f);
+			}
+
+			Target[x * 4 + 3] = (unsigned char)std::min(Alpha + 0.5f, 255.0f);
+		}
+	}
+}
@@ -0,0 +1,6 @@
+#pragma once
+#include "DdsLoader.h"
+
+/* Resamples Source to Width x Height. Shrinking averages the covered area (box filter), enlarging interpolates bilinearly.
+   Filtering runs on premultiplied alpha so transparent pixels do not darken the edges. */
+void ResampleImage(const DecodedImage& Source, int Width, int Height, DecodedImage& Result);
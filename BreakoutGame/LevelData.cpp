@@ -0,0 +1,154 @@
+#include "LevelData.h"
+#include "AssetPack.h"
+#include "LevelImage.h"
+#include "Profiler.h"
+#include <cstring>
+#include <algorithm>
+#include <climits>
+#include <iterator>
+#include <stdlib.h>
+
+#pragma warning(push)
+#pragma warning(disable: 26812) // Prefer enum class over enum  
+#include "tinyxml2.h"
+#pragma warning(pop)
+
+using namespace tinyxml2;
+
+LevelData::LevelData()
+{
+	IndexBrickTypes(*this);
+}
+
+void IndexBrickTypes(LevelData& Level)
+{
+	std::fill(std::begin(Level.CellTypes), std::end(Level.CellTypes), NoBrickType);
+
+	for (size_t i = 0; i < Level.BrickTypes.size() && i < NoBrickType; i++)
+	{
+		if (!Level.BrickTypes[i].Id.empty()) Level.CellTypes[(unsigned char)Level.BrickTypes[i].Id[0]] = (unsigned char)i;
+	}
+
+	Level.CellTypes[(unsigned char)'_'] = NoBrickType;
+}
+
+static void ReadLevelDocument(tinyxml2::XMLDocument& Document, LevelData& Level)
+{
+	XMLElement* LevelElement = Document.FirstChildElement("Level");
+	LevelElement->QueryIntAttribute("RowCount", &Level.RowCount);
+	LevelElement->QueryIntAttribute("ColumnCount", &Level.ColumnCount);
+	LevelElement->QueryIntAttribute("RowSpacing", &Level.RowSpacing);
+	LevelElement->QueryIntAttribute("ColumnSpacing", &Level.ColumnSpacing);
+
+	Level.BackgroundPath = AssetName(LevelElement->Attribute("BackgroundTexture"));
+
+	XMLElement* BrickTypesElement = LevelElement->FirstChildElement("BrickTypes");
+	std::vector<XMLElement*> BrickTypeElements;
+
+	for (XMLElement* BrickTypeElement = BrickTypesElement->FirstChildElement("BrickType"); BrickTypeElement != nullptr; BrickTypeElement = BrickTypeElement->NextSiblingElement("BrickType"))
+	{
+		BrickTypeElements.push_back(BrickTypeElement);
+	}
+
+	for (int i = 0; i < BrickTypeElements.size(); i++)
+	{
+		BrickType Brick;
+
+		Brick.Id = BrickTypeElements.at(i)->Attribute("Id");
+		Brick.Texture = AssetName(BrickTypeElements.at(i)->Attribute("Texture"));
+		Brick.HitPoints = atoi(BrickTypeElements.at(i)->Attribute("HitPoints"));
+		Brick.HitSound = AssetName(BrickTypeElements.at(i)->Attribute("HitSound"));
+
+		if (i != BrickTypeElements.size() - 1)
+		{
+			Brick.BreakSound = AssetName(BrickTypeElements.at(i)->Attribute("BreakSound"));
+			Brick.BreakScore = atoi(BrickTypeElements.at(i)->Attribute("BreakScore"));
+		}
+
+		/* The last BrickType is impenetrable */
+		else
+		{
+			Brick.HitPoints = INT_MAX;
+			Brick.BreakSound = AssetName();
+			Brick.BreakScore = 0;
+		}
+
+		Level.BrickTypes.push_back(Brick);
+	}
+
+	XMLElement* BricksElement = LevelElement->FirstChildElement("Bricks");
+	const char* Bricks = BricksElement->GetText();
+	if (Bricks == nullptr) Bricks = "";
+
+	/* One line per row, spaces separate the cells. The first pass measures the grid so the second can fill it without growing. */
+	BrickLayout& Layout = Level.BricksLayout;
+	int RowWidth = 0;
+
+	for (const char* Character = Bricks; *Character != 0; Character++)
+	{
+		if (*Character == '\n')
+		{
+			Layout.Height++;
+			Layout.Width = std::max(Layout.Width, RowWidth);
+			RowWidth = 0;
+		}
+
+		else if (*Character != ' ') RowWidth++;
+	}
+
+	/* The last line counts even without a line break after it */
+	if (*Bricks != 0 && Bricks[std::strlen(Bricks) - 1] != '\n')
+	{
+		Layout.Height++;
+		Layout.Width = std::max(Layout.Width, RowWidth);
+	}
+
+	Layout.Cells.assign((size_t)Layout.Width * Layout.Height, '_');
+
+	int Row = 0;
+	int Column = 0;
+
+	for (const char* Character = Bricks; *Character != 0; Character++)
+	{
+		if (*Character == '\n')
+		{
+			Row++;
+			Column = 0;
+		}
+
+		else if (*Character != ' ') Layout.Cells[(size_t)Row * Layout.Width + Column++] = *Character;
+	}
+
+	IndexBrickTypes(Level);
+}
+
+bool ParseLevel(const char* Text, size_t Size, LevelData& Level)
+{
+	Level = LevelData();
+
+	tinyxml2::XMLDocument Document;
+	if (Document.Parse(Text, Size) != XML_SUCCESS) return false;
+
+	ReadLevelDocument(Document, Level);
+	return true;
+}
+
+bool LoadLevel(const char* Path, LevelData& Level)
+{
+	PROFILE_ZONE("LoadLevel");
+
+	/* A compiled image from the cooker needs no parsing */
+	if (LoadCompiledLevel(Path, Level)) return true;
+
+	const unsigned char* Data;
+	size_t Size;
+	if (AssetPack::Find(Path, Data, Size)) return ParseLevel(reinterpret_cast<const char*>(Data), Size, Level);
+
+	Level = LevelData();
+
+	tinyxml2::XMLDocument Document;
+	if (Document.LoadFile(Path) != XML_SUCCESS) return false;
+
+	ReadLevelDocument(Document, Level);
+	return true;
+}
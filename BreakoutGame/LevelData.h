@@ -0,0 +1,55 @@
+#pragma once
+#include "AssetName.h"
+#include <string>
+#include <vector>
+
+/* Immutable description of one kind of brick, shared by every brick of that kind through its index in LevelData::BrickTypes */
+struct BrickType {
+    int HitPoints = 0;
+    int BreakScore = 0;
+    std::string Id = "";
+    AssetName Texture;
+    AssetName HitSound;
+    AssetName BreakSound;
+};
+
+/* Layout characters of a level in one row-major buffer. Rows shorter than the widest row of the document are padded with '_'. */
+struct BrickLayout
+{
+    int Width = 0;
+    int Height = 0;
+    std::vector<char> Cells;
+
+    char At(int Row, int Column) const { return Cells[(size_t)Row * Width + Column]; }
+    const char* GetRow(int Row) const { return Cells.data() + (size_t)Row * Width; }
+};
+
+/* Value of LevelData::CellTypes for characters that are no brick */
+const unsigned char NoBrickType = 0xFF;
+
+/* Everything read from a level XML document. Never modified after loading, so one instance can be shared by many games. */
+struct LevelData
+{
+    int RowCount = 0;
+    int ColumnCount = 0;
+    int RowSpacing = 0;
+    int ColumnSpacing = 0;
+    AssetName BackgroundPath;
+    std::vector<BrickType> BrickTypes;
+    BrickLayout BricksLayout;
+
+    /* Index into BrickTypes for every layout character, NoBrickType for '_' and characters no BrickType uses. Filled by IndexBrickTypes. */
+    unsigned char CellTypes[256];
+
+    /* An empty level, every cell maps to NoBrickType */
+    LevelData();
+};
+
+/* Fills CellTypes from the Ids of BrickTypes. A later BrickType with the same Id wins, types beyond the 255th can not be placed. */
+void IndexBrickTypes(LevelData& Level);
+
+/* Loads a level from the XML document at Path, or from its compiled image if the cooker produced an up to date one. Returns false if neither could be loaded. */
+bool LoadLevel(const char* Path, LevelData& Level);
+
+/* Reads a level from an XML document in memory. Returns false if the text is not a valid document. */
+bool ParseLevel(const char* Text, size_t Size, LevelData& Level);
@@ -0,0 +1,167 @@
+#include "LevelImage.h"
+#include "AssetCooker.h"
+#include "AssetPack.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+const char LevelImageMagic[4] = { 'B', 'L', 'V', 'L' };
+const uint32_t LevelImageVersion = 1;
+
+/* True if Offset plus Count items of ItemSize fit into Size bytes */
+static bool FitsInside(uint64_t Offset, uint64_t Count, uint64_t ItemSize, uint64_t Size)
+{
+	return Offset <= Size && Count * ItemSize <= Size - Offset;
+}
+
+bool LevelImage::Init(const unsigned char* Data, size_t Size)
+{
+	this->Data = nullptr;
+	Header = nullptr;
+
+	if (Size < sizeof(LevelImageHeader)) return false;
+
+	const LevelImageHeader* Candidate = reinterpret_cast<const LevelImageHeader*>(Data);
+	if (std::memcmp(Candidate->Magic, LevelImageMagic, sizeof(LevelImageMagic)) != 0 || Candidate->Version != LevelImageVersion) return false;
+	if (Candidate->FileSize != Size) return false;
+
+	if (!FitsInside(Candidate->BrickTypesOffset, Candidate->BrickTypeCount, sizeof(LevelImageBrickType), Size)) return false;
+	if (Candidate->BrickTypesOffset % alignof(LevelImageBrickType) != 0) return false;
+	if (!FitsInside(Candidate->LayoutOffset, (uint64_t)Candidate->LayoutWidth * Candidate->LayoutHeight, 1, Size)) return false;
+	if (!FitsInside(Candidate->StringsOffset, Candidate->StringsSize, 1, Size)) return false;
+
+	/* A terminated table means every string starting inside it ends inside it too */
+	const unsigned char* Strings = Data + Candidate->StringsOffset;
+	if (Candidate->StringsSize == 0 || Strings[Candidate->StringsSize - 1] != 0) return false;
+	if (Candidate->BackgroundPath >= Candidate->StringsSize) return false;
+
+	const LevelImageBrickType* Types = reinterpret_cast<const LevelImageBrickType*>(Data + Candidate->BrickTypesOffset);
+	for (uint32_t i = 0; i < Candidate->BrickTypeCount; i++)
+	{
+		uint32_t Largest = std::max(std::max(Types[i].Id, Types[i].Texture), std::max(Types[i].HitSound, Types[i].BreakSound));
+		if (Largest >= Candidate->StringsSize) return false;
+	}
+
+	this->Data = Data;
+	Header = Candidate;
+	return true;
+}
+
+void LevelImage::ToLevelData(LevelData& Level) const
+{
+	Level = LevelData();
+	Level.RowCount = Header->RowCount;
+	Level.ColumnCount = Header->ColumnCount;
+	Level.RowSpacing = Header->RowSpacing;
+	Level.ColumnSpacing = Header->ColumnSpacing;
+	Level.BackgroundPath = AssetName(GetString(Header->BackgroundPath));
+
+	Level.BrickTypes.resize(Header->BrickTypeCount);
+	for (uint32_t i = 0; i < Header->BrickTypeCount; i++)
+	{
+		const LevelImageBrickType& Source = GetBrickType(i);
+		BrickType& Type = Level.BrickTypes[i];
+		Type.HitPoints = Source.HitPoints;
+		Type.BreakScore = Source.BreakScore;
+		Type.Id = GetString(Source.Id);
+		Type.Texture = AssetName(GetString(Source.Texture));
+		Type.HitSound = AssetName(GetString(Source.HitSound));
+		Type.BreakSound = AssetName(GetString(Source.BreakSound));
+	}
+
+	Level.BricksLayout.Width = Header->LayoutWidth;
+	Level.BricksLayout.Height = Header->LayoutHeight;
+	Level.BricksLayout.Cells.assign(GetLayout(), GetLayout() + (size_t)Header->LayoutWidth * Header->LayoutHeight);
+
+	IndexBrickTypes(Level);
+}
+
+/* Appends a zero terminated string and returns its offset */
+static uint32_t AddString(const std::string& Text, std::vector<unsigned char>& Strings)
+{
+	uint32_t Offset = (uint32_t)Strings.size();
+	Strings.insert(Strings.end(), Text.begin(), Text.end());
+	Strings.push_back(0);
+	return Offset;
+}
+
+void CompileLevel(const LevelData& Level, std::vector<unsigned char>& Image)
+{
+	std::vector<unsigned char> Strings;
+
+	LevelImageHeader Header;
+	std::memset(&Header, 0, sizeof(Header));
+	std::memcpy(Header.Magic, LevelImageMagic, sizeof(LevelImageMagic));
+	Header.Version = LevelImageVersion;
+	Header.RowCount = Level.RowCount;
+	Header.ColumnCount = Level.ColumnCount;
+	Header.RowSpacing = Level.RowSpacing;
+	Header.ColumnSpacing = Level.ColumnSpacing;
+	Header.BackgroundPath = AddString(Level.BackgroundPath.GetPath(), Strings);
+
+	std::vector<LevelImageBrickType> Types(Level.BrickTypes.size());
+	for (size_t i = 0; i < Level.BrickTypes.size(); i++)
+	{
+		const BrickType& Source = Level.BrickTypes[i];
+		Types[i].HitPoints = Source.HitPoints;
+		Types[i].BreakScore = Source.BreakScore;
+		Types[i].Id = AddString(Source.Id, Strings);
+		Types[i].Texture = AddString(Source.Texture.GetPath(), Strings);
+		Types[i].HitSound = AddString(Source.HitSound.GetPath(), Strings);
+		Types[i].BreakSound = AddString(Source.BreakSound.GetPath(), Strings);
+	}
+
+	Header.LayoutWidth = Level.BricksLayout.Width;
+	Header.LayoutHeight = Level.BricksLayout.Height;
+	Header.BrickTypeCount = (uint32_t)Types.size();
+	Header.BrickTypesOffset = sizeof(LevelImageHeader);
+	Header.LayoutOffset = Header.BrickTypesOffset + Header.BrickTypeCount * sizeof(LevelImageBrickType);
+	Header.StringsOffset = Header.LayoutOffset + Header.LayoutWidth * Header.LayoutHeight;
+	Header.StringsSize = (uint32_t)Strings.size();
+	Header.FileSize = Header.StringsOffset + Header.StringsSize;
+
+	Image.assign(Header.FileSize, 0);
+	std::memcpy(Image.data(), &Header, sizeof(Header));
+	if (!Types.empty()) std::memcpy(Image.data() + Header.BrickTypesOffset, Types.data(), Types.size() * sizeof(LevelImageBrickType));
+
+	std::copy(Level.BricksLayout.Cells.begin(), Level.BricksLayout.Cells.end(), Image.data() + Header.LayoutOffset);
+
+	std::memcpy(Image.data() + Header.StringsOffset, Strings.data(), Strings.size());
+}
+
+bool LoadCompiledLevel(const char* SourcePath, LevelData& Level)
+{
+	std::string Path = GetCookedLevelPath(SourcePath);
+	LevelImage Image;
+
+	const unsigned char* Data;
+	size_t Size;
+
+	if (AssetPack::Find(Path.c_str(), Data, Size))
+	{
+		if (!Image.Init(Data, Size))
+		{
+			std::cerr << "Compiled Level is corrupt: " << Path << std::endl;
+			return false;
+		}
+
+		Image.ToLevelData(Level);
+		return true;
+	}
+
+	if (!IsCookedUpToDate(Path, SourcePath)) return false;
+
+	MappedFile File;
+	if (!File.Open(Path.c_str())) return false;
+
+	if (!Image.Init(File.GetData(), File.GetSize()))
+	{
+		std::cerr << "Compiled Level is corrupt: " << Path << std::endl;
+		return false;
+	}
+
+	Image.ToLevelData(Level);
+	return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "LevelData.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Compiled level, little endian. The header is followed by the brick type table, the layout grid and the string table.
+   Strings are referenced by their offset into the string table and are zero terminated. */
+struct LevelImageHeader
+{
+    char Magic[4];
+    uint32_t Version;
+    uint32_t FileSize;
+    int32_t RowCount;
+    int32_t ColumnCount;
+    int32_t RowSpacing;
+    int32_t ColumnSpacing;
+    uint32_t BackgroundPath;
+    uint32_t BrickTypeCount;
+    uint32_t BrickTypesOffset;
+
+    /* Row-major cells, one byte each, laid out like BrickLayout */
+    uint32_t LayoutWidth;
+    uint32_t LayoutHeight;
+    uint32_t LayoutOffset;
+
+    uint32_t StringsOffset;
+    uint32_t StringsSize;
+};
+
+struct LevelImageBrickType
+{
+    int32_t HitPoints;
+    int32_t BreakScore;
+    uint32_t Id;
+    uint32_t Texture;
+    uint32_t HitSound;
+    uint32_t BreakSound;
+};
+
+/* Read-only view of a compiled level in memory, e.g. a mapped file. Accessors point straight into the image, nothing is parsed or copied. */
+class LevelImage
+{
+
+private:
+    const unsigned char* Data;
+    const LevelImageHeader* Header;
+
+public:
+    LevelImage() : Data(nullptr), Header(nullptr) {}
+
+    /* Checks the header and that every table, cell and string lies inside the image. Returns false for a truncated or corrupt image. */
+    bool Init(const unsigned char* Data, size_t Size);
+
+    const LevelImageHeader& GetHeader() const { return *Header; }
+    const LevelImageBrickType& GetBrickType(int Index) const { return reinterpret_cast<const LevelImageBrickType*>(Data + Header->BrickTypesOffset)[Index]; }
+    const char* GetLayout() const { return reinterpret_cast<const char*>(Data + Header->LayoutOffset); }
+    char GetCell(int Row, int Column) const { return GetLayout()[(size_t)Row * Header->LayoutWidth + Column]; }
+    const char* GetString(uint32_t Offset) const { return reinterpret_cast<const char*>(Data + Header->StringsOffset + Offset); }
+
+    /* Copies the level into the form the simulation plays */
+    void ToLevelData(LevelData& Level) const;
+};
+
+/* Writes Level as a compiled level image */
+void CompileLevel(const LevelData& Level, std::vector<unsigned char>& Image);
+
+/* Loads the compiled image of the level document at SourcePath from the mounted asset pack, or maps it from the cooked files if it is up to date.
+   Returns false without logging if there is none and logs if it is corrupt. */
+bool LoadCompiledLevel(const char* SourcePath, LevelData& Level);
@@ -0,0 +1,91 @@
+#include "LevelStreamer.h"
+#include "TextureCache.h"
+#include "Profiler.h"
+
+LevelStreamer::LevelStreamer() :
+	PendingIndex(-1),
+	bStop(false),
+	bDecodeTextures(true),
+	Ready(nullptr)
+{
+}
+
+LevelStreamer::~LevelStreamer()
+{
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		bStop = true;
+	}
+
+	Wake.notify_one();
+	if (Worker.joinable()) Worker.join();
+
+	delete Ready.exchange(nullptr);
+}
+
+void LevelStreamer::Start(bool bDecodeTextures)
+{
+	if (Worker.joinable()) return;
+
+	this->bDecodeTextures = bDecodeTextures;
+	Worker = std::thread(&LevelStreamer::Run, this);
+}
+
+void LevelStreamer::Request(int Index, const char* Path)
+{
+	{
+		std::lock_guard<std::mutex> Lock(Mutex);
+		PendingIndex = Index;
+		PendingPath = Path;
+	}
+
+	Wake.notify_one();
+}
+
+std::unique_ptr<PreparedLevel> LevelStreamer::TakeReady()
+{
+	/* Cheap enough to poll every frame, the exchange only happens when the worker published something */
+	if (Ready.load(std::memory_order_relaxed) == nullptr) return nullptr;
+	return std::unique_ptr<PreparedLevel>(Ready.exchange(nullptr, std::memory_order_acquire));
+}
+
+void LevelStreamer::Run()
+{
+	std::unique_lock<std::mutex> Lock(Mutex);
+
+	while (true)
+	{
+		Wake.wait(Lock, [this] { return bStop || PendingIndex >= 0; });
+		if (bStop) return;
+
+		std::unique_ptr<PreparedLevel> Prepared(new PreparedLevel());
+		Prepared->Index = PendingIndex;
+		std::string Path = PendingPath;
+		PendingIndex = -1;
+		Lock.unlock();
+
+		{
+			PROFILE_ZONE("StreamLevel");
+
+			auto Level = std::make_shared<LevelData>();
+			LoadLevel(Path.c_str(), *Level);
+			Prepared->Level = Level;
+
+			if (bDecodeTextures)
+			{
+				if (!DecodeTextureFile(Level->BackgroundPath.GetPath(), Prepared->Background)) Prepared->Background = DecodedImage();
+
+				Prepared->BrickImages.resize(Level->BrickTypes.size());
+				for (size_t i = 0; i < Level->BrickTypes.size(); i++)
+				{
+					if (!DecodeTextureFile(Level->BrickTypes[i].Texture.GetPath(), Prepared->BrickImages[i])) Prepared->BrickImages[i] = DecodedImage();
+				}
+			}
+		}
+
+		/* A level the game thread never picked up is superseded by the newer one */
+		delete Ready.exchange(Prepared.release(), std::memory_order_acq_rel);
+
+		Lock.lock();
+	}
+}
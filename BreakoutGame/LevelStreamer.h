@@ -0,0 +1,61 @@
+#pragma once
+#include "DdsLoader.h"
+#include "LevelData.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* A level parsed and its textures decoded off the game thread, ready to be handed to the simulation and uploaded */
+struct PreparedLevel
+{
+    int Index = -1;
+    std::shared_ptr<const LevelData> Level;
+
+    /* Empty images for textures that failed to decode. BrickImages is parallel to Level->BrickTypes. */
+    DecodedImage Background;
+    std::vector<DecodedImage> BrickImages;
+};
+
+/* Loads one level ahead on a worker thread. The game thread requests the next level when a level starts
+   and picks the result up with TakeReady, which never blocks, so the level transition itself does no file or decode work. */
+class LevelStreamer
+{
+
+private:
+    std::thread Worker;
+    std::mutex Mutex;
+    std::condition_variable Wake;
+
+    /* Latest request not yet picked up by the worker, guarded by Mutex. A new request replaces an older one. */
+    int PendingIndex;
+    std::string PendingPath;
+    bool bStop;
+
+    /* Decodes textures as well. Off for headless games, which have nothing to upload them to. */
+    bool bDecodeTextures;
+
+    /* Finished level published by the worker, swapped out by TakeReady */
+    std::atomic<PreparedLevel*> Ready;
+
+    void Run();
+
+public:
+    LevelStreamer();
+    ~LevelStreamer();
+
+    /* Starts the worker thread */
+    void Start(bool bDecodeTextures);
+
+    /* Asks the worker to prepare the level document at Path as level Index. Replaces a request the worker has not started yet. */
+    void Request(int Index, const char* Path);
+
+    /* Returns the last level the worker finished and clears it, or nullptr if none is ready */
+    std::unique_ptr<PreparedLevel> TakeReady();
+
+    LevelStreamer(const LevelStreamer&) = delete;
+    LevelStreamer& operator=(const LevelStreamer&) = delete;
+};
@@ -0,0 +1,106 @@
+#include "MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() :
+	Data(nullptr),
+	Size(0),
+	FileHandle(nullptr),
+	MappingHandle(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const char* Path)
+{
+	Close();
+
+	const unsigned char* Mapped = nullptr;
+	size_t MappedSize = 0;
+
+#ifdef _WIN32
+	HANDLE File = CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (File == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER FileSize;
+	if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart <= 0)
+	{
+		CloseHandle(File);
+		return false;
+	}
+
+	HANDLE Mapping = CreateFileMappingA(File, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (Mapping != NULL) Mapped = static_cast<const unsigned char*>(MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0));
+	MappedSize = (size_t)FileSize.QuadPart;
+
+	if (Mapped == nullptr)
+	{
+		std::cerr << "Mapping file failed: " << Path << std::endl;
+		if (Mapping != NULL) CloseHandle(Mapping);
+		CloseHandle(File);
+		return false;
+	}
+
+	FileHandle = File;
+	MappingHandle = Mapping;
+#else
+	int File = open(Path, O_RDONLY);
+	if (File < 0) return false;
+
+	struct stat Status;
+	if (fstat(File, &Status) != 0 || Status.st_size <= 0)
+	{
+		close(File);
+		return false;
+	}
+
+	void* Mapping = mmap(nullptr, (size_t)Status.st_size, PROT_READ, MAP_SHARED, File, 0);
+	if (Mapping != MAP_FAILED) Mapped = static_cast<const unsigned char*>(Mapping);
+	MappedSize = (size_t)Status.st_size;
+
+	/* The mapping keeps the file alive */
+	close(File);
+
+	if (Mapped == nullptr)
+	{
+		std::cerr << "Mapping file failed: " << Path << std::endl;
+		return false;
+	}
+#endif
+
+	Data = Mapped;
+	Size = MappedSize;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (Data == nullptr) return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(Data);
+	CloseHandle(static_cast<HANDLE>(MappingHandle));
+	CloseHandle(static_cast<HANDLE>(FileHandle));
+#else
+	munmap(const_cast<unsigned char*>(Data), Size);
+#endif
+
+	Data = nullptr;
+	Size = 0;
+	FileHandle = nullptr;
+	MappingHandle = nullptr;
+}
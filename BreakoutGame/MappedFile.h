@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+
+/* Read-only memory mapping of a whole file, unmapped on destruction. Processes mapping the same file share its pages. */
+class MappedFile
+{
+
+private:
+    const unsigned char* Data;
+    size_t Size;
+
+    /* Platform handles kept to unmap the file */
+    void* FileHandle;
+    void* MappingHandle;
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /* Maps the file at Path, closing a previous mapping. Returns false without logging if the file does not exist or is empty and logs if it can not be mapped. */
+    bool Open(const char* Path);
+
+    /* Unmaps the file. Every pointer into the mapping becomes invalid. */
+    void Close();
+
+    bool IsOpen() const { return Data != nullptr; }
+    const unsigned char* GetData() const { return Data; }
+    size_t GetSize() const { return Size; }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
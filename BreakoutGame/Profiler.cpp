@@ -0,0 +1,158 @@
+#include "Profiler.h"
+#include "SDL.h"
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/* Zones kept per thread. Older zones are overwritten once a ring is full. */
+const unsigned long long RingCapacity = 1 << 16;
+
+struct ZoneRecord
+{
+	std::atomic<const char*> Name;
+	std::atomic<unsigned long long> BeginCounter;
+	std::atomic<unsigned long long> EndCounter;
+};
+
+/* Written only by its own thread. WriteIndex is published after the record, so a reader sees complete records
+   and can tell which of them may have been overwritten while it was copying. */
+struct ThreadRing
+{
+	int ThreadId;
+	std::unique_ptr<ZoneRecord[]> Records;
+	std::atomic<unsigned long long> WriteIndex;
+};
+
+std::atomic<bool> Profiler::bEnabled(false);
+
+/* Rings are never freed, so the zones of finished threads can still be written */
+static std::mutex RingsMutex;
+static std::vector<std::unique_ptr<ThreadRing>> Rings;
+static thread_local ThreadRing* LocalRing = nullptr;
+
+static ThreadRing* GetLocalRing()
+{
+	if (LocalRing != nullptr) return LocalRing;
+
+	auto Ring = std::make_unique<ThreadRing>();
+	Ring->Records = std::make_unique<ZoneRecord[]>(RingCapacity);
+	Ring->WriteIndex = 0;
+
+	std::lock_guard<std::mutex> Lock(RingsMutex);
+	Ring->ThreadId = (int)Rings.size() + 1;
+	LocalRing = Ring.get();
+	Rings.push_back(std::move(Ring));
+	return LocalRing;
+}
+
+void Profiler::SetEnabled(bool bEnabled)
+{
+	Profiler::bEnabled.store(bEnabled);
+}
+
+unsigned long long Profiler::ReadCounter()
+{
+	return SDL_GetPerformanceCounter();
+}
+
+void Profiler::Record(const char* Name, unsigned long long BeginCounter, unsigned long long EndCounter)
+{
+	ThreadRing* Ring = GetLocalRing();
+	unsigned long long Index = Ring->WriteIndex.load(std::memory_order_relaxed);
+
+	ZoneRecord& Record = Ring->Records[Index % RingCapacity];
+	Record.Name.store(Name, std::memory_order_relaxed);
+	Record.BeginCounter.store(BeginCounter, std::memory_order_relaxed);
+	Record.EndCounter.store(EndCounter, std::memory_order_relaxed);
+
+	Ring->WriteIndex.store(Index + 1, std::memory_order_release);
+}
+
+void Profiler::Reset()
+{
+	std::lock_guard<std::mutex> Lock(RingsMutex);
+
+	for (auto& Ring : Rings)
+	{
+		Ring->WriteIndex.store(0, std::memory_order_release);
+	}
+}
+
+struct CopiedZone
+{
+	int ThreadId;
+	const char* Name;
+	unsigned long long BeginCounter;
+	unsigned long long EndCounter;
+};
+
+bool Profiler::WriteChromeTrace(const char* Path)
+{
+	std::vector<CopiedZone> Zones;
+	std::vector<int> ThreadIds;
+
+	{
+		std::lock_guard<std::mutex> Lock(RingsMutex);
+
+		for (auto& Ring : Rings)
+		{
+			ThreadIds.push_back(Ring->ThreadId);
+
+			unsigned long long End = Ring->WriteIndex.load(std::memory_order_acquire);
+			unsigned long long Begin = End > RingCapacity ? End - RingCapacity : 0;
+			size_t FirstCopied = Zones.size();
+
+			for (unsigned long long Index = Begin; Index < End; Index++)
+			{
+				ZoneRecord& Record = Ring->Records[Index % RingCapacity];
+				Zones.push_back({ Ring->ThreadId, Record.Name.load(std::memory_order_relaxed), Record.BeginCounter.load(std::memory_order_relaxed), Record.EndCounter.load(std::memory_order_relaxed) });
+			}
+
+			/* Records the owning thread overwrote while they were copied are dropped. The slot at EndAfterCopy may be
+			   half written without being published yet, and once the ring is full it is the oldest copied slot, so it is dropped as well. */
+			std::atomic_thread_fence(std::memory_order_acquire);
+			unsigned long long EndAfterCopy = Ring->WriteIndex.load(std::memory_order_relaxed);
+			unsigned long long FirstValid = EndAfterCopy + 1 > RingCapacity ? EndAfterCopy + 1 - RingCapacity : 0;
+			if (FirstValid > Begin)
+			{
+				size_t Overwritten = (size_t)std::min(FirstValid - Begin, End - Begin);
+				Zones.erase(Zones.begin() + FirstCopied, Zones.begin() + FirstCopied + Overwritten);
+			}
+		}
+	}
+
+	std::ofstream File(Path);
+	if (!File) return false;
+
+	unsigned long long BaseCounter = ~0ull;
+	for (const CopiedZone& Zone : Zones)
+	{
+		BaseCounter = std::min(BaseCounter, Zone.BeginCounter);
+	}
+
+	double MicrosecondsPerCount = 1e6 / (double)SDL_GetPerformanceFrequency();
+
+	File << "{\"traceEvents\":[\n";
+
+	bool bFirst = true;
+	for (int ThreadId : ThreadIds)
+	{
+		if (!bFirst) File << ",\n";
+		bFirst = false;
+		File << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ThreadId << ",\"args\":{\"name\":\"Thread " << ThreadId << "\"}}";
+	}
+
+	for (const CopiedZone& Zone : Zones)
+	{
+		if (!bFirst) File << ",\n";
+		bFirst = false;
+		File << "{\"name\":\"" << Zone.Name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << Zone.ThreadId
+			<< ",\"ts\":" << (Zone.BeginCounter - BaseCounter) * MicrosecondsPerCount
+			<< ",\"dur\":" << (Zone.EndCounter - Zone.BeginCounter) * MicrosecondsPerCount << "}";
+	}
+
+	File << "\n]}\n";
+	return (bool)File;
+}
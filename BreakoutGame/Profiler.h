@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+
+/* Records timed zones into a lock-free ring buffer per thread and writes them as Chrome trace JSON,
+   which chrome://tracing and ui.perfetto.dev can open. Zones are only recorded while the profiler is enabled. */
+class Profiler
+{
+
+private:
+    static std::atomic<bool> bEnabled;
+
+public:
+    static void SetEnabled(bool bEnabled);
+    static bool IsEnabled() { return bEnabled.load(std::memory_order_relaxed); }
+
+    /* Raw timestamp in performance counter ticks */
+    static unsigned long long ReadCounter();
+
+    /* Stores a finished zone in the ring buffer of the calling thread. Name must outlive the profiler, e.g. a string literal. */
+    static void Record(const char* Name, unsigned long long BeginCounter, unsigned long long EndCounter);
+
+    /* Drops all recorded zones. Call while the profiler is disabled. */
+    static void Reset();
+
+    /* Writes the zones still held by the ring buffers of all threads. Returns false if the file can not be written. */
+    static bool WriteChromeTrace(const char* Path);
+};
+
+/* Times the enclosing scope */
+class ProfileZone
+{
+
+private:
+    const char* Name;
+    unsigned long long BeginCounter;
+
+public:
+    explicit ProfileZone(const char* Name) :
+        Name(Name),
+        BeginCounter(Profiler::IsEnabled() ? Profiler::ReadCounter() : 0)
+    {
+    }
+
+    ~ProfileZone()
+    {
+        if (BeginCounter != 0) Profiler::Record(Name, BeginCounter, Profiler::ReadCounter());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(A, B) A##B
+#define PROFILE_CONCAT(A, B) PROFILE_CONCAT_INNER(A, B)
+#define PROFILE_ZONE(Name) ProfileZone PROFILE_CONCAT(ProfileZone_, __LINE__)(Name)
@@ -0,0 +1,90 @@
+#include "SoundBank.h"
+#include "AssetPack.h"
+#include "SDL_mixer.h"
+#include "Profiler.h"
+#include <iostream>
+
+SoundBank::~SoundBank()
+{
+	Clear();
+}
+
+void SoundBank::Init(bool bEnabled)
+{
+	this->bEnabled = bEnabled;
+}
+
+int SoundBank::Load(const std::string& Path)
+{
+	const unsigned char* Data;
+	size_t Size;
+	if (AssetPack::Find(Path.c_str(), Data, Size)) return Load(Path, Data, Size);
+	return Load(Path, nullptr, 0);
+}
+
+int SoundBank::Load(AssetName Name)
+{
+	int Id;
+	if (NameIds.Find(Name, Id)) return Id;
+
+	Id = Load(Name.GetPath());
+	NameIds.Set(Name, Id);
+	return Id;
+}
+
+int SoundBank::Load(const std::string& Path, const unsigned char* Data, size_t Size)
+{
+	if (!bEnabled || Path.empty()) return -1;
+
+	auto Found = Ids.find(Path);
+	if (Found != Ids.end()) return Found->second;
+
+	/* Failed loads are cached as well so a missing file is not read again on every hit */
+	int Id = -1;
+	Mix_Chunk* Chunk = Data != nullptr ? Mix_LoadWAV_RW(SDL_RWFromConstMem(Data, (int)Size), 1) : Mix_LoadWAV(Path.c_str());
+
+	if (Chunk != nullptr)
+	{
+		Id = static_cast<int>(Chunks.size());
+		Chunks.push_back(Chunk);
+	}
+
+	else
+	{
+		std::cerr << "Loading Sound failed: " << Path << " " << Mix_GetError() << std::endl;
+	}
+
+	Ids[Path] = Id;
+	return Id;
+}
+
+void SoundBank::Play(int Id)
+{
+	if (Id < 0 || Id >= (int)Chunks.size()) return;
+	Pending.push_back(Id);
+}
+
+void SoundBank::Flush()
+{
+	PROFILE_ZONE("Audio");
+
+	for (int Id : Pending)
+	{
+		Mix_PlayChannel(-1, Chunks[Id], 0);
+	}
+
+	Pending.clear();
+}
+
+void SoundBank::Clear()
+{
+	for (Mix_Chunk* Chunk : Chunks)
+	{
+		Mix_FreeChunk(Chunk);
+	}
+
+	Chunks.clear();
+	Ids.clear();
+	NameIds.Clear();
+	Pending.clear();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "AssetName.h"
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class SoundBank
+{
+
+private:
+    /* False when there is no audio device. Nothing is loaded or played then. */
+    bool bEnabled;
+
+    /* Loaded sounds, indexed by id */
+    std::vector<struct Mix_Chunk*> Chunks;
+
+    /* Maps a sound path to its id so every file is decoded only once */
+    std::unordered_map<std::string, int> Ids;
+
+    /* Sound ids of the names passed to Load */
+    AssetHandleTable NameIds;
+
+    /* Sounds requested since the last Flush */
+    std::vector<int> Pending;
+
+public:
+    SoundBank() : bEnabled(true) {}
+    ~SoundBank();
+
+    /* Enables or disables the bank. A disabled bank returns -1 for every sound. */
+    void Init(bool bEnabled);
+
+    /* Returns the id of the sound at Path. Loads the file the first time it is requested. Returns -1 for an empty path, a disabled bank or on failure. */
+    int Load(const std::string& Path);
+
+    /* Same as Load with the path, resolved by id after the first call */
+    int Load(AssetName Name);
+
+    /* Like Load, but decodes file contents already read into memory, e.g. by a loader thread. Data is only used during the call, a null Data reads the file at Path. */
+    int Load(const std::string& Path, const unsigned char* Data, size_t Size);
+
+    /* Enqueues a sound to be played on the next Flush. Invalid ids are ignored. */
+    void Play(int Id);
+
+    /* Plays all enqueued sounds */
+    void Flush();
+
+    /* Frees all sounds. Must be called before audio is closed. */
+    void Clear();
+};
@@ -0,0 +1,188 @@
+#include "SpriteAtlas.h"
+#include "ImageResampler.h"
+#include "SDL.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+/* Sprites are packed into rows of this width. The atlas height grows to fit. */
+const int AtlasWidth = 1024;
+
+/* Every sprite is surrounded by a copy of its edge pixels, so linear filtering never samples a neighbouring sprite */
+const int SpritePadding = 1;
+
+/* Widest sprite that fits into a shelf together with its padding */
+const int MaxSpriteWidth = AtlasWidth - 2 * SpritePadding;
+
+SpriteAtlas::SpriteAtlas() :
+	Renderer(nullptr),
+	Texture(nullptr),
+	Width(0),
+	Height(0),
+	bDirty(false)
+{
+}
+
+SpriteAtlas::~SpriteAtlas()
+{
+	Clear();
+}
+
+void SpriteAtlas::Init(SDL_Renderer* Renderer)
+{
+	this->Renderer = Renderer;
+}
+
+int SpriteAtlas::Add(const std::string& Path)
+{
+	if (Renderer == nullptr) return -1;
+
+	auto Found = Handles.find(Path);
+	if (Found != Handles.end()) return Found->second;
+
+	/* Failed loads are cached as well so a missing file is not read again */
+	DecodedImage Image;
+	if (!DecodeTextureFile(Path, Image))
+	{
+		Handles[Path] = -1;
+		return -1;
+	}
+
+	return Add(Path, std::move(Image));
+}
+
+int SpriteAtlas::Add(const std::string& Path, DecodedImage&& Image)
+{
+	if (Renderer == nullptr) return -1;
+
+	auto Found = Handles.find(Path);
+	if (Found != Handles.end()) return Found->second;
+
+	int Handle = -1;
+
+	/* Sprites come from level data, so a texture wider than the atlas is shrunk to fit instead of overrunning the atlas rows */
+	if (Image.Width > MaxSpriteWidth)
+	{
+		std::cerr << "Sprite wider than the atlas, downscaling: " << Path << " (" << Image.Width << "x" << Image.Height << ")" << std::endl;
+
+		DecodedImage Scaled;
+		ResampleImage(Image, MaxSpriteWidth, std::max(1, (int)((long long)Image.Height * MaxSpriteWidth / Image.Width)), Scaled);
+		Image = std::move(Scaled);
+	}
+
+	if (Image.Width > 0 && Image.Height > 0)
+	{
+		Handle = static_cast<int>(Images.size());
+		Images.push_back(std::move(Image));
+		Rects.push_back({ 0, 0, 0, 0 });
+		bDirty = true;
+	}
+
+	Handles[Path] = Handle;
+	return Handle;
+}
+
+int SpriteAtlas::Add(AssetName Name)
+{
+	int Handle;
+	if (NameHandles.Find(Name, Handle)) return Handle;
+
+	Handle = Add(Name.GetPath());
+	NameHandles.Set(Name, Handle);
+	return Handle;
+}
+
+void SpriteAtlas::Build()
+{
+	if (!bDirty) return;
+	bDirty = false;
+
+	/* Shelf packing: tallest sprites first, a new shelf starts when a row is full */
+	std::vector<int> Order(Images.size());
+	for (int i = 0; i < (int)Order.size(); i++)
+	{
+		Order[i] = i;
+	}
+
+	std::sort(Order.begin(), Order.end(), [&](int a, int b) { return Images[a].Height > Images[b].Height; });
+
+	std::vector<int> PositionX(Images.size());
+	std::vector<int> PositionY(Images.size());
+	int ShelfX = 0;
+	int ShelfY = 0;
+	int ShelfHeight = 0;
+
+	for (int i : Order)
+	{
+		int PaddedWidth = Images[i].Width + 2 * SpritePadding;
+		int PaddedHeight = Images[i].Height + 2 * SpritePadding;
+
+		if (ShelfX + PaddedWidth > AtlasWidth)
+		{
+			ShelfY += ShelfHeight;
+			ShelfX = 0;
+			ShelfHeight = 0;
+		}
+
+		PositionX[i] = ShelfX + SpritePadding;
+		PositionY[i] = ShelfY + SpritePadding;
+		ShelfX += PaddedWidth;
+		ShelfHeight = std::max(ShelfHeight, PaddedHeight);
+	}
+
+	Width = AtlasWidth;
+	Height = 1;
+	while (Height < ShelfY + ShelfHeight) Height *= 2;
+
+	std::vector<unsigned char> Pixels((size_t)Width * Height * 4, 0);
+
+	for (int i = 0; i < (int)Images.size(); i++)
+	{
+		const DecodedImage& Image = Images[i];
+
+		/* Copy the sprite including its padding, clamping to the sprite edges */
+		for (int y = -SpritePadding; y < Image.Height + SpritePadding; y++)
+		{
+			int SourceY = std::min(std::max(y, 0), Image.Height - 1);
+			unsigned char* Row = &Pixels[((size_t)(PositionY[i] + y) * Width + PositionX[i]) * 4];
+
+			for (int x = -SpritePadding; x < 0; x++)
+			{
+				memcpy(Row + x * 4, &Image.Pixels[(size_t)SourceY * Image.Width * 4], 4);
+			}
+
+			memcpy(Row, &Image.Pixels[(size_t)SourceY * Image.Width * 4], (size_t)Image.Width * 4);
+
+			for (int x = Image.Width; x < Image.Width + SpritePadding; x++)
+			{
+				memcpy(Row + x * 4, &Image.Pixels[((size_t)SourceY * Image.Width + Image.Width - 1) * 4], 4);
+			}
+		}
+
+		Rects[i] = { (float)PositionX[i] / Width, (float)PositionY[i] / Height, (float)(PositionX[i] + Image.Width) / Width, (float)(PositionY[i] + Image.Height) / Height };
+	}
+
+	if (Texture != nullptr) SDL_DestroyTexture(Texture);
+	Texture = SDL_CreateTexture(Renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, Width, Height);
+
+	if (Texture == nullptr)
+	{
+		std::cerr << "Creating sprite atlas failed: " << SDL_GetError() << std::endl;
+		return;
+	}
+
+	SDL_UpdateTexture(Texture, NULL, Pixels.data(), Width * 4);
+	SDL_SetTextureBlendMode(Texture, SDL_BLENDMODE_BLEND);
+}
+
+void SpriteAtlas::Clear()
+{
+	if (Texture != nullptr) SDL_DestroyTexture(Texture);
+	Texture = nullptr;
+
+	Images.clear();
+	Rects.clear();
+	Handles.clear();
+	NameHandles.Clear();
+	bDirty = false;
+}
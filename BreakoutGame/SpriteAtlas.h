@@ -0,0 +1,67 @@
+#pragma once
+#include "TextureCache.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Normalized texture coordinates of a sprite inside the atlas texture */
+struct SpriteRect
+{
+    float U0;
+    float V0;
+    float U1;
+    float V1;
+};
+
+/* Packs small textures into one texture, so everything drawn from it can go to the GPU in a single batch */
+class SpriteAtlas
+{
+
+private:
+    /* Renderer that owns the atlas texture */
+    struct SDL_Renderer* Renderer;
+    struct SDL_Texture* Texture;
+    int Width;
+    int Height;
+
+    /* Decoded sprites, indexed by handle. Kept so the atlas can be rebuilt when a level adds sprites. */
+    std::vector<DecodedImage> Images;
+    std::vector<SpriteRect> Rects;
+
+    /* Maps a texture path to its handle so every file is decoded only once */
+    std::unordered_map<std::string, int> Handles;
+
+    /* Handles of the names passed to Add */
+    AssetHandleTable NameHandles;
+
+    /* Set by Add when the atlas texture is missing sprites */
+    bool bDirty;
+
+public:
+    SpriteAtlas();
+    ~SpriteAtlas();
+
+    /* Sets the Renderer used for uploading the atlas. Without a Renderer nothing is loaded and every handle is -1. */
+    void Init(struct SDL_Renderer* Renderer);
+
+    /* Returns the handle of the sprite at Path, decoding the file the first time. Returns -1 on failure. Takes effect with the next Build. */
+    int Add(const std::string& Path);
+
+    /* Same as Add with the path, resolved by id after the first call */
+    int Add(AssetName Name);
+
+    /* Adds an image decoded elsewhere, e.g. by a loader thread, as the sprite at Path. Returns the existing handle if Path was added before.
+       Images wider than the atlas are downscaled to fit. */
+    int Add(const std::string& Path, DecodedImage&& Image);
+
+    /* Packs all sprites and uploads the atlas texture. Does nothing if no sprite was added since the last Build. */
+    void Build();
+
+    struct SDL_Texture* GetTexture() const { return Texture; }
+
+    /* Returns where the sprite of a handle returned by Add lies in the atlas */
+    const SpriteRect& GetRect(int Handle) const { return Rects[Handle]; }
+
+    /* Destroys the atlas texture and forgets all sprites. Must be called before the Renderer is destroyed. */
+    void Clear();
+};
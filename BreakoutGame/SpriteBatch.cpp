@@ -0,0 +1,38 @@
+#include "SpriteBatch.h"
+
+void SpriteBatch::AddSprite(float x, float y, float w, float h, const SpriteRect& Rect)
+{
+	const SDL_Color White = { 255, 255, 255, 255 };
+	int First = (int)Vertices.size();
+
+	Vertices.push_back({ { x, y }, White, { Rect.U0, Rect.V0 } });
+	Vertices.push_back({ { x + w, y }, White, { Rect.U1, Rect.V0 } });
+	Vertices.push_back({ { x + w, y + h }, White, { Rect.U1, Rect.V1 } });
+	Vertices.push_back({ { x, y + h }, White, { Rect.U0, Rect.V1 } });
+
+	int QuadIndices[6] = { First, First + 1, First + 2, First, First + 2, First + 3 };
+	Indices.insert(Indices.end(), QuadIndices, QuadIndices + 6);
+}
+
+void SpriteBatch::AddFrame(float x, float y, float w, float h)
+{
+	Frames.push_back({ (int)x, (int)y, (int)w, (int)h });
+}
+
+void SpriteBatch::Submit(SDL_Renderer* Renderer, SDL_Texture* Texture, SDL_Color FrameColor)
+{
+	if (!Indices.empty())
+	{
+		SDL_RenderGeometry(Renderer, Texture, Vertices.data(), (int)Vertices.size(), Indices.data(), (int)Indices.size());
+	}
+
+	if (!Frames.empty())
+	{
+		SDL_SetRenderDrawColor(Renderer, FrameColor.r, FrameColor.g, FrameColor.b, FrameColor.a);
+		SDL_RenderDrawRects(Renderer, Frames.data(), (int)Frames.size());
+	}
+
+	Vertices.clear();
+	Indices.clear();
+	Frames.clear();
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "SDL.h"
+#include "SpriteAtlas.h"
+#include <vector>
+
+/* Collects textured quads and outline rectangles during a frame and draws each kind with one call */
+class SpriteBatch
+{
+
+private:
+    std::vector<SDL_Vertex> Vertices;
+    std::vector<int> Indices;
+    std::vector<SDL_Rect> Frames;
+
+public:
+    /* Queues a quad in pixels showing the sprite at Rect */
+    void AddSprite(float x, float y, float w, float h, const SpriteRect& Rect);
+
+    /* Queues a rectangle outline in pixels */
+    void AddFrame(float x, float y, float w, float h);
+
+    /* Draws all quads with one SDL_RenderGeometry call and all outlines with one SDL_RenderDrawRects call, then empties the batch */
+    void Submit(SDL_Renderer* Renderer, SDL_Texture* Texture, SDL_Color FrameColor);
+};
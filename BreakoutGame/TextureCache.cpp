@@ -0,0 +1,161 @@
+#include "TextureCache.h"
+#include "AssetCooker.h"
+#include "ImageResampler.h"
+#include "Profiler.h"
+#include "SDL.h"
+#include <iostream>
+
+TextureCache::TextureCache() :
+	Renderer(nullptr)
+{
+}
+
+TextureCache::~TextureCache()
+{
+	Clear();
+}
+
+void TextureCache::Init(SDL_Renderer* Renderer)
+{
+	this->Renderer = Renderer;
+}
+
+bool DecodeTextureFile(const std::string& Path, DecodedImage& Image)
+{
+	if (LoadCookedTexture(Path, Image)) return true;
+
+	if (!LoadDdsFile(Path, Image))
+	{
+		std::cerr << "Loading Texture failed: " << Path << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+int TextureCache::Load(const std::string& Path)
+{
+	if (Renderer == nullptr) return -1;
+
+	auto Found = Handles.find(Path);
+	if (Found != Handles.end()) return Found->second;
+
+	/* Failed loads are cached as well so a missing file is not read again every frame */
+	DecodedImage Image;
+	if (!DecodeTextureFile(Path, Image))
+	{
+		Handles[Path] = -1;
+		return -1;
+	}
+
+	return Load(Path, std::move(Image));
+}
+
+int TextureCache::Load(const std::string& Path, DecodedImage&& Image)
+{
+	if (Renderer == nullptr) return -1;
+
+	auto Found = Handles.find(Path);
+	if (Found != Handles.end()) return Found->second;
+
+	int Handle = -1;
+
+	/* The texture is uploaded at its native size, SDL_RenderCopy scales it to the on-screen size */
+	SDL_Texture* Texture = Image.Width > 0 && Image.Height > 0 ? SDL_CreateTexture(Renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, Image.Width, Image.Height) : nullptr;
+
+	if (Texture != nullptr)
+	{
+		SDL_UpdateTexture(Texture, NULL, Image.Pixels.data(), Image.Width * 4);
+		SDL_SetTextureBlendMode(Texture, SDL_BLENDMODE_BLEND);
+		Handle = static_cast<int>(Textures.size());
+		Textures.push_back(Texture);
+		Images.push_back(std::move(Image));
+		Paths.push_back(Path);
+	}
+
+	else
+	{
+		std::cerr << "Creating Texture failed: " << Path << " " << SDL_GetError() << std::endl;
+	}
+
+	Handles[Path] = Handle;
+	return Handle;
+}
+
+int TextureCache::Load(AssetName Name)
+{
+	/* Names resolved before skip the path lookup entirely */
+	int Handle;
+	if (NameHandles.Find(Name, Handle)) return Handle;
+
+	Handle = Load(Name.GetPath());
+	NameHandles.Set(Name, Handle);
+	return Handle;
+}
+
+SDL_Texture* TextureCache::Get(int Handle) const
+{
+	if (Handle < 0 || Handle >= (int)Textures.size()) return nullptr;
+	return Textures[Handle];
+}
+
+SDL_Texture* TextureCache::GetScaled(int Handle, int Width, int Height)
+{
+	SDL_Texture* Native = Get(Handle);
+	if (Native == nullptr || Width <= 0 || Height <= 0) return Native;
+
+	const DecodedImage& Source = Images[Handle];
+	if (Source.Width == Width && Source.Height == Height) return Native;
+
+	unsigned long long Key = ((unsigned long long)Handle << 40) | ((unsigned long long)Width << 20) | (unsigned long long)Height;
+	auto Found = Scaled.find(Key);
+	if (Found != Scaled.end()) return Found->second != nullptr ? Found->second : Native;
+
+	PROFILE_ZONE("ResampleTexture");
+
+	DecodedImage Image;
+	if (!LoadCookedTexture(Paths[Handle], Image, Width, Height)) ResampleImage(Source, Width, Height, Image);
+
+	SDL_Texture* Texture = SDL_CreateTexture(Renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, Width, Height);
+
+	if (Texture != nullptr)
+	{
+		SDL_UpdateTexture(Texture, NULL, Image.Pixels.data(), Width * 4);
+		SDL_SetTextureBlendMode(Texture, SDL_BLENDMODE_BLEND);
+	}
+
+	else
+	{
+		std::cerr << "Creating scaled Texture failed: " << SDL_GetError() << std::endl;
+	}
+
+	/* Failures are cached as well and fall back to the native texture */
+	Scaled[Key] = Texture;
+	return Texture != nullptr ? Texture : Native;
+}
+
+void TextureCache::ClearScaled()
+{
+	for (auto& Entry : Scaled)
+	{
+		if (Entry.second != nullptr) SDL_DestroyTexture(Entry.second);
+	}
+
+	Scaled.clear();
+}
+
+void TextureCache::Clear()
+{
+	ClearScaled();
+
+	for (SDL_Texture* Texture : Textures)
+	{
+		SDL_DestroyTexture(Texture);
+	}
+
+	Textures.clear();
+	Images.clear();
+	Paths.clear();
+	Handles.clear();
+	NameHandles.Clear();
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "AssetName.h"
+#include "DdsLoader.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Reads the cooked blob of a texture if one is up to date, decodes the DDS file otherwise. Logs and returns false on failure. */
+bool DecodeTextureFile(const std::string& Path, DecodedImage& Image);
+
+class TextureCache
+{
+
+private:
+    /* Renderer that owns all uploaded textures */
+    struct SDL_Renderer* Renderer;
+
+    /* Uploaded textures, indexed by handle */
+    std::vector<struct SDL_Texture*> Textures;
+
+    /* Decoded pixels of every uploaded texture, indexed by handle, kept as the source for resampled copies */
+    std::vector<DecodedImage> Images;
+
+    /* Source path of every uploaded texture, indexed by handle, used to find pre-scaled cooked blobs */
+    std::vector<std::string> Paths;
+
+    /* Maps a texture path to its handle so every file is decoded only once */
+    std::unordered_map<std::string, int> Handles;
+
+    /* Handles of the names passed to Load */
+    AssetHandleTable NameHandles;
+
+    /* Resampled copies keyed by handle and target size, see GetScaled */
+    std::unordered_map<unsigned long long, struct SDL_Texture*> Scaled;
+
+public:
+    TextureCache();
+    ~TextureCache();
+
+    /* Sets the Renderer used for uploading textures. Without a Renderer nothing is loaded and every handle is -1. */
+    void Init(struct SDL_Renderer* Renderer);
+
+    /* Returns the handle of the texture at Path. Decodes and uploads the file the first time it is requested. Returns -1 on failure. */
+    int Load(const std::string& Path);
+
+    /* Same as Load with the path, resolved by id after the first call */
+    int Load(AssetName Name);
+
+    /* Uploads an image decoded elsewhere, e.g. by a loader thread, as the texture at Path. Returns the existing handle if Path was loaded before. */
+    int Load(const std::string& Path, DecodedImage&& Image);
+
+    /* Returns the texture for a handle returned by Load, or nullptr for an invalid handle */
+    struct SDL_Texture* Get(int Handle) const;
+
+    /* Returns the texture for a handle resampled on the CPU to exactly Width x Height, so it can be drawn 1:1 without GPU filtering.
+       Every size is resampled, or read from a pre-scaled cooked blob, once and cached until ClearScaled. Falls back to the native texture if resampling fails. */
+    struct SDL_Texture* GetScaled(int Handle, int Width, int Height);
+
+    /* Destroys all resampled textures, e.g. after the window size changed */
+    void ClearScaled();
+
+    /* Destroys all textures. Must be called before the Renderer is destroyed. */
+    void Clear();
+};
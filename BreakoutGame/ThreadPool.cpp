@@ -0,0 +1,122 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int ThreadCount) :
+	Generation(0),
+	bStop(false),
+	Remaining(0)
+{
+	if (ThreadCount <= 0) ThreadCount = std::max((int)std::thread::hardware_concurrency(), 1);
+
+	for (int i = 0; i < ThreadCount; i++)
+	{
+		Queues.push_back(std::make_unique<TaskQueue>());
+	}
+
+	for (int i = 1; i < ThreadCount; i++)
+	{
+		Threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> Lock(WakeMutex);
+		bStop = true;
+	}
+
+	WakeCondition.notify_all();
+
+	for (std::thread& Thread : Threads)
+	{
+		Thread.join();
+	}
+}
+
+void ThreadPool::ParallelFor(int Count, int ChunkSize, const std::function<void(int, int)>& Body)
+{
+	if (Count <= 0) return;
+	ChunkSize = std::max(ChunkSize, 1);
+
+	int ChunkCount = (Count + ChunkSize - 1) / ChunkSize;
+	Remaining = ChunkCount;
+
+	/* Deal the chunks round-robin, neighbouring chunks end up on different threads */
+	for (int Chunk = 0; Chunk < ChunkCount; Chunk++)
+	{
+		TaskQueue& Queue = *Queues[Chunk % Queues.size()];
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+		Queue.Tasks.push_back({ Chunk * ChunkSize, std::min((Chunk + 1) * ChunkSize, Count), &Body });
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(WakeMutex);
+		Generation++;
+	}
+
+	WakeCondition.notify_all();
+
+	RunTasks(0);
+
+	/* Other threads may still be running the last stolen chunks */
+	while (Remaining.load() > 0)
+	{
+		std::this_thread::yield();
+	}
+}
+
+void ThreadPool::WorkerLoop(int Index)
+{
+	unsigned long long SeenGeneration = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> Lock(WakeMutex);
+			WakeCondition.wait(Lock, [&] { return bStop || Generation != SeenGeneration; });
+			if (bStop) return;
+			SeenGeneration = Generation;
+		}
+
+		RunTasks(Index);
+	}
+}
+
+void ThreadPool::RunTasks(int Index)
+{
+	Task Current;
+
+	while (PopTask(Index, Current) || StealTask(Index, Current))
+	{
+		(*Current.Body)(Current.Begin, Current.End);
+		Remaining.fetch_sub(1);
+	}
+}
+
+bool ThreadPool::PopTask(int Index, Task& Result)
+{
+	TaskQueue& Queue = *Queues[Index];
+	std::lock_guard<std::mutex> Lock(Queue.Mutex);
+	if (Queue.Tasks.empty()) return false;
+
+	Result = Queue.Tasks.back();
+	Queue.Tasks.pop_back();
+	return true;
+}
+
+bool ThreadPool::StealTask(int Index, Task& Result)
+{
+	for (size_t Offset = 1; Offset < Queues.size(); Offset++)
+	{
+		TaskQueue& Queue = *Queues[(Index + Offset) % Queues.size()];
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+		if (Queue.Tasks.empty()) continue;
+
+		Result = Queue.Tasks.front();
+		Queue.Tasks.pop_front();
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Fixed set of worker threads running ParallelFor jobs. Every thread owns a task queue; it takes work from the back
+   of its own queue and steals from the front of the others when it runs dry, so uneven chunks still keep all cores busy. */
+class ThreadPool
+{
+
+private:
+    struct Task
+    {
+        int Begin;
+        int End;
+        const std::function<void(int, int)>* Body;
+    };
+
+    struct TaskQueue
+    {
+        std::mutex Mutex;
+        std::deque<Task> Tasks;
+    };
+
+    std::vector<std::thread> Threads;
+
+    /* One queue per worker thread plus queue 0 for the thread calling ParallelFor */
+    std::vector<std::unique_ptr<TaskQueue>> Queues;
+
+    std::mutex WakeMutex;
+    std::condition_variable WakeCondition;
+    unsigned long long Generation;
+    bool bStop;
+
+    /* Tasks of the current ParallelFor that have not finished yet */
+    std::atomic<int> Remaining;
+
+    void WorkerLoop(int Index);
+
+    /* Runs tasks from the own queue, then steals, until no task is left anywhere */
+    void RunTasks(int Index);
+
+    bool PopTask(int Index, Task& Result);
+    bool StealTask(int Index, Task& Result);
+
+public:
+    /* Starts ThreadCount - 1 workers, the calling thread is the last one. 0 uses one thread per hardware thread. */
+    explicit ThreadPool(int ThreadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /* Number of threads taking part in ParallelFor, including the caller */
+    int GetThreadCount() const { return (int)Queues.size(); }
+
+    /* Calls Body(Begin, End) for consecutive chunks of [0, Count) of at most ChunkSize items and returns when all of them are done */
+    void ParallelFor(int Count, int ChunkSize, const std::function<void(int, int)>& Body);
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include <cmath>
+
+union Vector2D
+{
+    struct { float x, y; };
+    float Values[2];
+};
+
+struct Box2D
+{
+    Vector2D min;
+    Vector2D max;
+};
+
+/* Operators for easy vector addition, vector substraction etc. */
+inline Vector2D operator+(Vector2D a, Vector2D b)
+{
+    return { a.x + b.x, a.y + b.y };
+}
+
+inline Vector2D operator-(Vector2D a, Vector2D b)
+{
+    return { a.x - b.x, a.y - b.y };
+}
+
+inline Vector2D operator*(Vector2D vector, float scalar)
+{
+    return { vector.x * scalar, vector.y * scalar };
+}
+
+inline float dot(Vector2D a, Vector2D b)
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+inline float lengthSquared(Vector2D vector)
+{
+    return dot(vector, vector);
+}
+
+inline float length(Vector2D vector)
+{
+    return (float)sqrt(lengthSquared(vector));
+}
+
+inline Vector2D normalize(Vector2D vector)
+{
+    float inverseLength = 1.0f / length(vector);
+    return { vector.x * inverseLength, vector.y * inverseLength };
+}
+
+inline Vector2D lerp(Vector2D a, Vector2D b, float alpha)
+{
+    return { a.x + (b.x - a.x) * alpha, a.y + (b.y - a.y) * alpha };
+}
@@ -1,8 +1,64 @@
 #include <iostream>
 #include "GameMode.h"
+#include "Benchmark.h"
+#include "AssetCooker.h"
+#include "AssetPack.h"
+#include <string>
+#include <stdlib.h>
 
 int main(int argc, char* args[])
 {
+	if (argc > 1 && std::string(args[1]) == "--benchmark-sweep")
+	{
+		return RunSweepBenchmark();
+	}
+
+	if (argc > 1 && std::string(args[1]) == "--benchmark-dds")
+	{
+		return RunDdsBenchmark();
+	}
+
+	if (argc > 1 && std::string(args[1]) == "--benchmark-levels")
+	{
+		return RunLevelBenchmark();
+	}
+
+	if (argc > 1 && std::string(args[1]) == "--cook")
+	{
+		int Width = argc > 3 ? atoi(args[2]) : 800;
+		int Height = argc > 3 ? atoi(args[3]) : 600;
+		return RunAssetCooker(Width, Height);
+	}
+
+	if (argc > 1 && std::string(args[1]) == "--pack")
+	{
+		return BuildAssetPack(argc > 2 ? args[2] : "Assets.pak");
+	}
+
+	/* Every asset below is read from the pack when one is shipped, from loose files otherwise */
+	AssetPack::Mount("Assets.pak");
+
+	if (argc > 1 && std::string(args[1]) == "--batch")
+	{
+		int Games = argc > 2 ? atoi(args[2]) : 1024;
+		int Steps = argc > 3 ? atoi(args[3]) : 10000;
+		return RunBatchBenchmark(Games, Steps);
+	}
+
+	if (argc > 1 && std::string(args[1]) == "--headless")
+	{
+		int Ticks = argc > 2 ? atoi(args[2]) : 100000;
+		GameMode Game(800, 600, true, Ticks);
+		return 0;
+	}
+
+	if (argc > 1 && std::string(args[1]) == "--tick-rate")
+	{
+		int TickRate = argc > 2 ? atoi(args[2]) : 120;
+		GameMode Game(800, 600, false, 0, TickRate);
+		return 0;
+	}
+
 	GameMode Game(800, 600);
 	
 	return 0;